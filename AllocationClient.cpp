@@ -0,0 +1,109 @@
+/**
+   AllocationClient.cpp
+
+   See AllocationClient.hpp.
+
+*/
+
+#include "AllocationClient.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const char *REQUEST_MAGIC = "RAQ1";
+const char *RESPONSE_MAGIC = "RAR1";
+
+};  // namespace
+
+AllocationClient::AllocationClient(const std::string &socket_path)
+    : socketPath(socket_path) {}
+
+AllocationClient::~AllocationClient() { disconnect(); }
+
+void AllocationClient::connect() {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Socket path too long: " + socketPath);
+  }
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+  fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                          sizeof(address)) != 0) {
+    const std::string reason = std::strerror(errno);
+    disconnect();
+    throw std::runtime_error("Cannot connect to " + socketPath + ": " +
+                             reason);
+  }
+}
+
+void AllocationClient::disconnect() noexcept {
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+RegisterAssignment AllocationClient::send(AllocationRequest::Kind kind,
+                                          std::string graph,
+                                          int num_registers, Engine engine) {
+  request.kind = kind;
+  request.engine = engine;
+  request.numRegisters = num_registers;
+  request.graph = std::move(graph);
+  encodeRequest(request, buffer);
+
+  // A kept connection may have been closed by a restarted server since
+  // the last request, so a failed write gets one fresh connection.
+  const bool reused = fd >= 0;
+  if (!reused) {
+    connect();
+  }
+  bool sent = writeFrame(fd, REQUEST_MAGIC, buffer);
+  if (!sent && reused) {
+    disconnect();
+    connect();
+    sent = writeFrame(fd, REQUEST_MAGIC, buffer);
+  }
+  if (!sent || !readFrame(fd, RESPONSE_MAGIC, buffer) ||
+      !decodeResponse(buffer, response)) {
+    disconnect();
+    throw std::runtime_error("Lost connection to allocation server at " +
+                             socketPath);
+  }
+
+  if (!response.ok) {
+    throw std::runtime_error(response.error);
+  }
+  return std::move(response.assignment);
+}
+
+RegisterAssignment AllocationClient::assignRegisters(
+    const std::string &path_to_graph, int num_registers, Engine engine) {
+  // The server resolves paths against its own working directory, which
+  // is rarely the caller's.
+  return send(AllocationRequest::Kind::Path,
+              std::filesystem::absolute(path_to_graph).string(),
+              num_registers, engine);
+}
+
+RegisterAssignment AllocationClient::assignRegistersFromCsv(
+    const std::string &csv, int num_registers, Engine engine) {
+  return send(AllocationRequest::Kind::Csv, csv, num_registers, engine);
+}
+
+RegisterAssignment AllocationClient::assignRegisters(
+    const InterferenceGraph<Variable> &ig, int num_registers, Engine engine) {
+  return send(AllocationRequest::Kind::Binary, encodeGraph(ig), num_registers,
+              engine);
+}
@@ -0,0 +1,69 @@
+/**
+   AllocationClient.hpp
+
+   Client side of AllocationServer. The connection is opened on the
+   first request and kept for the following ones, so a build that sends
+   many small graphs pays for connect() once. One client is meant for one
+   thread; use a client per thread to send requests in parallel.
+
+   Results follow proj6::assignRegisters: an empty map if the graph does
+   not fit. Connection and protocol failures, and errors reported by the
+   server (an unreadable file, a malformed graph), throw
+   std::runtime_error.
+
+*/
+
+#ifndef ALLOCATION_CLIENT_H
+#define ALLOCATION_CLIENT_H
+
+#include <string>
+
+#include "AllocationProtocol.hpp"
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+class AllocationClient {
+ public:
+  explicit AllocationClient(const std::string &socket_path);
+
+  ~AllocationClient();
+
+  AllocationClient(const AllocationClient &) = delete;
+  AllocationClient &operator=(const AllocationClient &) = delete;
+
+  // The server reads the file itself. A relative path is made absolute
+  // against this process's working directory before it is sent.
+  RegisterAssignment assignRegisters(const std::string &path_to_graph,
+                                     int num_registers,
+                                     Engine engine = Engine::WelshPowell);
+
+  // `csv` holds the contents of a graph file.
+  RegisterAssignment assignRegistersFromCsv(
+      const std::string &csv, int num_registers,
+      Engine engine = Engine::WelshPowell);
+
+  // Sends the graph in the binary encoding.
+  RegisterAssignment assignRegisters(const InterferenceGraph<Variable> &ig,
+                                     int num_registers,
+                                     Engine engine = Engine::WelshPowell);
+
+ private:
+  RegisterAssignment send(AllocationRequest::Kind kind, std::string graph,
+                          int num_registers, Engine engine);
+
+  void connect();
+
+  void disconnect() noexcept;
+
+  std::string socketPath;
+  int fd = -1;
+
+  // Reused between requests.
+  AllocationRequest request;
+  AllocationResponse response;
+  std::string buffer;
+};
+
+#endif
@@ -0,0 +1,272 @@
+/**
+   AllocationProtocol.cpp
+
+   See AllocationProtocol.hpp for the frame and payload layouts.
+
+*/
+
+#include "AllocationProtocol.hpp"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "CSVReader.hpp"
+#include "Varint.hpp"
+
+namespace {
+
+const std::size_t FRAME_HEADER_BYTES = 8;
+
+bool readString(const std::string &in, std::size_t &pos, std::string &out) {
+  std::uint64_t length = 0;
+  if (!readVarint(in, pos, length) || length > in.size() - pos) {
+    return false;
+  }
+  out.assign(in, pos, static_cast<std::size_t>(length));
+  pos += static_cast<std::size_t>(length);
+  return true;
+}
+
+void writeString(std::string &out, const std::string &s) {
+  writeVarint(out, s.size());
+  out += s;
+}
+
+bool writeAll(int fd, const char *data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= static_cast<std::size_t>(sent);
+  }
+  return true;
+}
+
+bool readAll(int fd, char *data, std::size_t size) {
+  while (size > 0) {
+    const ssize_t got = recv(fd, data, size, 0);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    data += got;
+    size -= static_cast<std::size_t>(got);
+  }
+  return true;
+}
+
+};  // namespace
+
+void encodeRequest(const AllocationRequest &request, std::string &payload) {
+  payload.clear();
+  writeVarint(payload, static_cast<std::uint64_t>(request.kind));
+  writeVarint(payload, static_cast<std::uint64_t>(request.engine));
+  writeVarint(payload, static_cast<std::uint64_t>(
+                           request.numRegisters < 0 ? 0
+                                                    : request.numRegisters));
+  writeString(payload, request.graph);
+}
+
+bool decodeRequest(const std::string &payload, AllocationRequest &request) {
+  std::size_t pos = 0;
+  std::uint64_t kind = 0;
+  std::uint64_t engine = 0;
+  std::uint64_t numRegisters = 0;
+  if (!readVarint(payload, pos, kind) || kind > 2 ||
+      !readVarint(payload, pos, engine) || engine > static_cast<std::uint64_t>(Engine::Auto) ||
+      !readVarint(payload, pos, numRegisters) || numRegisters > 1 << 30 ||
+      !readString(payload, pos, request.graph)) {
+    return false;
+  }
+  request.kind = static_cast<AllocationRequest::Kind>(kind);
+  request.engine = static_cast<Engine>(engine);
+  request.numRegisters = static_cast<int>(numRegisters);
+  return pos == payload.size();
+}
+
+void encodeResponse(const AllocationResponse &response, std::string &payload) {
+  payload.clear();
+  writeVarint(payload, response.ok ? 0 : 1);
+  if (!response.ok) {
+    writeString(payload, response.error);
+    return;
+  }
+  writeVarint(payload, response.assignment.size());
+  for (const auto &[name, reg] : response.assignment) {
+    writeString(payload, name);
+    writeVarint(payload, static_cast<std::uint64_t>(reg));
+  }
+}
+
+bool decodeResponse(const std::string &payload,
+                    AllocationResponse &response) {
+  std::size_t pos = 0;
+  std::uint64_t status = 0;
+  if (!readVarint(payload, pos, status) || status > 1) {
+    return false;
+  }
+  response.ok = status == 0;
+  response.assignment.clear();
+  if (!response.ok) {
+    return readString(payload, pos, response.error) && pos == payload.size();
+  }
+
+  std::uint64_t count = 0;
+  if (!readVarint(payload, pos, count) || count > payload.size()) {
+    return false;
+  }
+  response.assignment.reserve(static_cast<std::size_t>(count));
+  std::string name;
+  for (std::uint64_t i = 0; i < count; i++) {
+    std::uint64_t reg = 0;
+    if (!readString(payload, pos, name) || !readVarint(payload, pos, reg)) {
+      return false;
+    }
+    response.assignment[name] = static_cast<Register>(reg);
+  }
+  return pos == payload.size();
+}
+
+std::string encodeGraph(const InterferenceGraph<Variable> &ig) {
+  std::string out;
+  std::vector<Variable> names;
+  std::unordered_map<Variable, std::uint64_t> index;
+  for (const auto &vertex : ig.vertices()) {
+    index.emplace(vertex, names.size());
+    names.push_back(vertex);
+  }
+
+  writeVarint(out, names.size());
+  for (const auto &name : names) {
+    writeString(out, name);
+  }
+  // Counted here rather than taken from numEdges(), which counts a
+  // self-loop as half an edge.
+  std::string edges;
+  std::uint64_t edgeCount = 0;
+  for (std::uint64_t v = 0; v < names.size(); v++) {
+    ig.forEachNeighbor(names[v], [&](const Variable &w) {
+      const std::uint64_t u = index.at(w);
+      if (v <= u) {
+        writeVarint(edges, v);
+        writeVarint(edges, u);
+        edgeCount++;
+      }
+    });
+  }
+  writeVarint(out, edgeCount);
+  out += edges;
+  return out;
+}
+
+InterferenceGraph<Variable> decodeGraph(const std::string &bytes) {
+  const auto bad = []() {
+    return std::runtime_error("Malformed binary graph");
+  };
+
+  std::size_t pos = 0;
+  std::uint64_t count = 0;
+  if (!readVarint(bytes, pos, count) || count > bytes.size()) {
+    throw bad();
+  }
+  InterferenceGraph<Variable> ig;
+  std::vector<Variable> names(static_cast<std::size_t>(count));
+  for (auto &name : names) {
+    if (!readString(bytes, pos, name)) {
+      throw bad();
+    }
+    ig.addVertex(name);
+  }
+
+  std::uint64_t edges = 0;
+  if (!readVarint(bytes, pos, edges)) {
+    throw bad();
+  }
+  for (std::uint64_t i = 0; i < edges; i++) {
+    std::uint64_t v = 0;
+    std::uint64_t w = 0;
+    if (!readVarint(bytes, pos, v) || !readVarint(bytes, pos, w) ||
+        v >= names.size() || w >= names.size()) {
+      throw bad();
+    }
+    ig.addEdge(names[v], names[w]);
+  }
+  if (pos != bytes.size()) {
+    throw bad();
+  }
+  return ig;
+}
+
+InterferenceGraph<Variable> parseCsvGraph(const std::string &text) {
+  InterferenceGraph<Variable> ig;
+  std::size_t start = 0;
+  std::string line;
+  while (start < text.size()) {
+    std::size_t end = text.find('\n', start);
+    if (end == std::string::npos) {
+      end = text.size();
+    }
+    line.assign(text, start, end - start);
+    start = end + 1;
+
+    const auto &row = CSVReader::readRow(line);
+    if (row.size() > 2) {
+      throw std::runtime_error(
+          "Graph contains row with more than two vertices");
+    }
+    for (const auto &v : row) {
+      ig.addVertex(v);
+    }
+    if (row.size() == 2) {
+      ig.addEdge(row.at(0), row.at(1));
+    }
+  }
+  return ig;
+}
+
+bool writeFrame(int fd, const char *magic, const std::string &payload) {
+  if (payload.size() > MAX_ALLOCATION_FRAME_BYTES) {
+    return false;
+  }
+  char header[FRAME_HEADER_BYTES];
+  std::memcpy(header, magic, 4);
+  for (int i = 0; i < 4; i++) {
+    header[4 + i] = static_cast<char>(payload.size() >> (8 * i));
+  }
+  return writeAll(fd, header, sizeof(header)) &&
+         writeAll(fd, payload.data(), payload.size());
+}
+
+bool readFrame(int fd, const char *magic, std::string &payload) {
+  char header[FRAME_HEADER_BYTES];
+  if (!readAll(fd, header, sizeof(header)) ||
+      std::memcmp(header, magic, 4) != 0) {
+    return false;
+  }
+  std::size_t size = 0;
+  for (int i = 0; i < 4; i++) {
+    size |= static_cast<std::size_t>(static_cast<unsigned char>(header[4 + i]))
+            << (8 * i);
+  }
+  if (size > MAX_ALLOCATION_FRAME_BYTES) {
+    return false;
+  }
+  // Reuses the caller's buffer capacity.
+  payload.resize(size);
+  return readAll(fd, &payload[0], size);
+}
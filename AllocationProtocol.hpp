@@ -0,0 +1,84 @@
+/**
+   AllocationProtocol.hpp
+
+   Wire format shared by AllocationServer and AllocationClient. Every
+   message is one frame on a Unix stream socket:
+
+     4 bytes   magic, "RAQ1" for requests and "RAR1" for responses
+     4 bytes   payload length, little endian
+     payload
+
+   Request payload (integers are varints, see Varint.hpp):
+
+     kind, engine, num_registers, graph length, graph bytes
+
+   where the graph is a file path the server can read, CSV text as in a
+   graph file, or a binary graph (encodeGraph below).
+
+   Response payload:
+
+     status (0 ok, 1 error)
+     ok:    count, count x { name length, name bytes, register }
+     error: message length, message bytes
+
+   An ok response with no entries means the graph does not fit, just
+   like the empty map from assignRegisters.
+
+*/
+
+#ifndef ALLOCATION_PROTOCOL_H
+#define ALLOCATION_PROTOCOL_H
+
+#include <cstddef>
+#include <string>
+
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+struct AllocationRequest {
+  enum class Kind { Path, Csv, Binary };
+
+  Kind kind = Kind::Path;
+  Engine engine = Engine::WelshPowell;
+  int numRegisters = 0;
+  std::string graph;
+};
+
+struct AllocationResponse {
+  bool ok = true;
+  std::string error;
+  RegisterAssignment assignment;
+};
+
+// Frames larger than this are refused by both sides.
+const std::size_t MAX_ALLOCATION_FRAME_BYTES = 256 * 1024 * 1024;
+
+void encodeRequest(const AllocationRequest &request, std::string &payload);
+
+bool decodeRequest(const std::string &payload, AllocationRequest &request);
+
+void encodeResponse(const AllocationResponse &response, std::string &payload);
+
+bool decodeResponse(const std::string &payload, AllocationResponse &response);
+
+// Binary graph: vertex count, names (length + bytes), edge count, then
+// each edge as two vertex indices. Smaller and faster to read than CSV.
+std::string encodeGraph(const InterferenceGraph<Variable> &ig);
+
+// Throws std::runtime_error on malformed input.
+InterferenceGraph<Variable> decodeGraph(const std::string &bytes);
+
+// Builds a graph from CSV text with the same rules as CSVReader::load.
+// Throws std::runtime_error on rows with more than two vertices.
+InterferenceGraph<Variable> parseCsvGraph(const std::string &text);
+
+// Blocking frame I/O on a connected socket. `magic` is "RAQ1" or "RAR1".
+// Both return false on a closed connection, an I/O error, a wrong magic
+// or an oversized frame.
+bool writeFrame(int fd, const char *magic, const std::string &payload);
+
+bool readFrame(int fd, const char *magic, std::string &payload);
+
+#endif
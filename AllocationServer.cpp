@@ -0,0 +1,320 @@
+/**
+   AllocationServer.cpp
+
+   See AllocationServer.hpp. The poll thread owns the listening socket
+   and every idle connection. A connection is in exactly one place at a
+   time: the poll thread's idle list, the `pending` queue, a worker, or
+   the `returned` list on its way back to the poll thread.
+
+*/
+
+#include "AllocationServer.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "InputFile.hpp"
+
+namespace {
+
+const char *REQUEST_MAGIC = "RAQ1";
+const char *RESPONSE_MAGIC = "RAR1";
+
+std::string readWholeFile(const std::string &path) {
+  InputFile file(path);
+  std::string text;
+  std::vector<char> buffer(64 * 1024);
+  for (;;) {
+    const std::size_t got = file.read(buffer.data(), buffer.size());
+    if (got == 0) {
+      return text;
+    }
+    text.append(buffer.data(), got);
+  }
+}
+
+};  // namespace
+
+AllocationServer::AllocationServer(const std::string &socket_path,
+                                   const AllocationServerOptions &options)
+    : socketPath(socket_path), options(options) {
+  this->options.threads = std::max(1u, options.threads);
+  this->options.maxCachedGraphs =
+      std::max<std::size_t>(1, options.maxCachedGraphs);
+}
+
+AllocationServer::~AllocationServer() { stop(); }
+
+void AllocationServer::start() {
+  if (listenFd >= 0) {
+    return;
+  }
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Socket path too long: " + socketPath);
+  }
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+  // Only ever remove a leftover socket, never a regular file.
+  struct stat info;
+  if (lstat(socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+    unlink(socketPath.c_str());
+  }
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (listenFd < 0 ||
+      bind(listenFd, reinterpret_cast<sockaddr *>(&address),
+           sizeof(address)) != 0 ||
+      listen(listenFd, SOMAXCONN) != 0 ||
+      pipe2(wakeFds, O_CLOEXEC | O_NONBLOCK) != 0) {
+    const std::string reason = std::strerror(errno);
+    if (listenFd >= 0) {
+      close(listenFd);
+      listenFd = -1;
+    }
+    throw std::runtime_error("Cannot listen on " + socketPath + ": " +
+                             reason);
+  }
+
+  stopping = false;
+  for (unsigned t = 0; t < options.threads; t++) {
+    workers.emplace_back(&AllocationServer::workerLoop, this);
+  }
+  poller = std::thread(&AllocationServer::pollLoop, this);
+}
+
+void AllocationServer::stop() {
+  if (listenFd < 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(queueLock);
+    stopping = true;
+  }
+  queueReady.notify_all();
+  wake();
+  poller.join();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+
+  // The poll thread closed its idle connections on the way out.
+  for (const int fd : pending) {
+    close(fd);
+  }
+  pending.clear();
+  for (const int fd : returned) {
+    close(fd);
+  }
+  returned.clear();
+  for (int &fd : wakeFds) {
+    close(fd);
+    fd = -1;
+  }
+  close(listenFd);
+  listenFd = -1;
+  unlink(socketPath.c_str());
+}
+
+void AllocationServer::wake() {
+  const char byte = 0;
+  // A full pipe already guarantees a wakeup, so the result is not needed.
+  (void)!write(wakeFds[1], &byte, 1);
+}
+
+void AllocationServer::acceptPending(std::vector<int> &idle) {
+  // Bounds how long a silent or slow peer can keep a worker waiting in
+  // the middle of a frame.
+  timeval timeout{};
+  timeout.tv_sec = static_cast<time_t>(options.ioTimeout.count() / 1000);
+  timeout.tv_usec =
+      static_cast<suseconds_t>(options.ioTimeout.count() % 1000 * 1000);
+
+  for (;;) {
+    const int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      return;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    idle.push_back(fd);
+  }
+}
+
+void AllocationServer::pollLoop() {
+  std::vector<int> idle;
+  std::vector<pollfd> polled;
+  for (;;) {
+    {
+      std::lock_guard<std::mutex> guard(queueLock);
+      if (stopping) {
+        break;
+      }
+      idle.insert(idle.end(), returned.begin(), returned.end());
+      returned.clear();
+    }
+
+    polled.clear();
+    polled.push_back({wakeFds[0], POLLIN, 0});
+    polled.push_back({listenFd, POLLIN, 0});
+    for (const int fd : idle) {
+      polled.push_back({fd, POLLIN, 0});
+    }
+    if (poll(polled.data(), polled.size(), -1) < 0) {
+      continue;
+    }
+
+    if (polled[0].revents != 0) {
+      char drain[64];
+      while (read(wakeFds[0], drain, sizeof(drain)) > 0) {
+      }
+    }
+
+    // Readable (or hung up) connections go to the workers, who find out
+    // which it is. The rest stay idle.
+    std::size_t kept = 0;
+    bool queued = false;
+    {
+      std::lock_guard<std::mutex> guard(queueLock);
+      for (std::size_t i = 0; i < idle.size(); i++) {
+        if (polled[i + 2].revents != 0) {
+          pending.push_back(idle[i]);
+          queued = true;
+        } else {
+          idle[kept++] = idle[i];
+        }
+      }
+    }
+    idle.resize(kept);
+    if (queued) {
+      queueReady.notify_all();
+    }
+
+    if (polled[1].revents != 0) {
+      acceptPending(idle);
+    }
+  }
+
+  for (const int fd : idle) {
+    close(fd);
+  }
+}
+
+void AllocationServer::workerLoop() {
+  Scratch scratch;
+  for (;;) {
+    int fd;
+    {
+      std::unique_lock<std::mutex> guard(queueLock);
+      queueReady.wait(guard, [this]() { return stopping || !pending.empty(); });
+      if (stopping) {
+        return;
+      }
+      fd = pending.front();
+      pending.pop_front();
+    }
+
+    if (!serveOne(fd, scratch)) {
+      close(fd);
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> guard(queueLock);
+      returned.push_back(fd);
+    }
+    wake();
+  }
+}
+
+bool AllocationServer::serveOne(int fd, Scratch &scratch) {
+  if (!readFrame(fd, REQUEST_MAGIC, scratch.in)) {
+    return false;
+  }
+
+  AllocationResponse response;
+  if (decodeRequest(scratch.in, scratch.request)) {
+    response = handle(scratch.request);
+  } else {
+    response.ok = false;
+    response.error = "Malformed request";
+  }
+  served++;
+
+  encodeResponse(response, scratch.out);
+  return writeFrame(fd, RESPONSE_MAGIC, scratch.out);
+}
+
+AllocationResponse AllocationServer::handle(
+    const AllocationRequest &request) {
+  AllocationResponse response;
+  try {
+    std::string fileText;
+    const std::string *bytes = &request.graph;
+    if (request.kind == AllocationRequest::Kind::Path) {
+      fileText = readWholeFile(request.graph);
+      bytes = &fileText;
+    }
+
+    // CSV and binary graphs with equal bytes are different graphs.
+    const bool binary = request.kind == AllocationRequest::Kind::Binary;
+    const std::string name =
+        (binary ? "b" : "c") + AssignmentCache::contentKey(*bytes).hex();
+
+    bool hit = false;
+    const auto cached = cachedGraph(name, hit);
+    std::lock_guard<std::mutex> guard(cached->lock);
+    if (!cached->context) {
+      hit = false;
+      cached->context = std::make_unique<AllocatorContext>(
+          binary ? decodeGraph(*bytes) : parseCsvGraph(*bytes));
+    }
+    if (hit) {
+      hits++;
+    }
+    response.assignment = cached->context->assignRegisters(
+        request.numRegisters, request.engine);
+  } catch (const std::exception &error) {
+    response.ok = false;
+    response.error = error.what();
+  }
+  return response;
+}
+
+std::shared_ptr<AllocationServer::CachedGraph> AllocationServer::cachedGraph(
+    const std::string &name, bool &hit) {
+  std::lock_guard<std::mutex> guard(cacheLock);
+  const auto found = cache.find(name);
+  if (found != cache.end()) {
+    lru.splice(lru.begin(), lru, found->second);
+    hit = true;
+    return found->second->second;
+  }
+
+  hit = false;
+  lru.emplace_front(name, std::make_shared<CachedGraph>());
+  cache[name] = lru.begin();
+  if (lru.size() > options.maxCachedGraphs) {
+    // Requests still using the evicted graph keep it alive.
+    cache.erase(lru.back().first);
+    lru.pop_back();
+  }
+  return lru.front().second;
+}
@@ -0,0 +1,141 @@
+/**
+   AllocationServer.hpp
+
+   Long-running local allocation service. It listens on a Unix domain
+   socket and answers AllocationProtocol requests, so that a build
+   running thousands of small allocations pays process startup, thread
+   creation and graph loading once instead of per invocation.
+
+     - One thread polls the listening socket and every idle connection.
+       When a connection has a request waiting, it is queued for the
+       fixed pool of worker threads, which is started once. A worker
+       reads and answers that one request and hands the connection back
+       to the poll thread. So a connection may carry any number of
+       requests, and idle connections hold no worker.
+     - A peer that stalls in the middle of a request (or does not read
+       its response) for longer than `ioTimeout` is disconnected.
+     - Every worker keeps its own request and response buffers, reused
+       for every request it serves.
+     - Graphs are cached by content (a 128-bit hash of the request's
+       graph bytes, or of the file's bytes for path requests) as
+       AllocatorContext objects. So a repeated graph skips parsing, and a
+       repeated (graph, engine) pair skips coloring for any register
+       count. The least recently used graphs are dropped past
+       `maxCachedGraphs`.
+
+   Path requests are resolved against the server's working directory;
+   AllocationClient sends absolute paths.
+   The socket is only as private as its file permissions and directory.
+
+*/
+
+#ifndef ALLOCATION_SERVER_H
+#define ALLOCATION_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "AllocationProtocol.hpp"
+#include "AllocatorContext.hpp"
+#include "AssignmentCache.hpp"
+
+struct AllocationServerOptions {
+  unsigned threads = 4;
+  std::size_t maxCachedGraphs = 256;
+  // Longest wait for the rest of a started request, or for the peer to
+  // take a response. Zero waits forever.
+  std::chrono::milliseconds ioTimeout{5000};
+};
+
+class AllocationServer {
+ public:
+  explicit AllocationServer(const std::string &socket_path,
+                            const AllocationServerOptions &options = {});
+
+  // Stops the server if it is running.
+  ~AllocationServer();
+
+  AllocationServer(const AllocationServer &) = delete;
+  AllocationServer &operator=(const AllocationServer &) = delete;
+
+  // Binds the socket (replacing a stale socket file, but never any other
+  // kind of file) and starts the workers. Returns once the server
+  // accepts connections. Throws std::runtime_error if it cannot listen.
+  void start();
+
+  // Stops accepting, finishes the requests in progress and joins every
+  // thread. The socket file is removed.
+  void stop();
+
+  // Requests answered so far, and how many of them found their graph in
+  // the cache.
+  unsigned long requests() const noexcept { return served.load(); }
+
+  unsigned long cacheHits() const noexcept { return hits.load(); }
+
+ private:
+  struct CachedGraph {
+    std::mutex lock;
+    std::unique_ptr<AllocatorContext> context;
+  };
+
+  // Per-worker buffers, kept for the worker's whole life.
+  struct Scratch {
+    std::string in;
+    std::string out;
+    AllocationRequest request;
+  };
+
+  void pollLoop();
+
+  void workerLoop();
+
+  // Reads and answers one request. Returns false if the connection is
+  // closed or broken.
+  bool serveOne(int fd, Scratch &scratch);
+
+  void acceptPending(std::vector<int> &idle);
+
+  void wake();
+
+  AllocationResponse handle(const AllocationRequest &request);
+
+  std::shared_ptr<CachedGraph> cachedGraph(const std::string &name, bool &hit);
+
+  std::string socketPath;
+  AllocationServerOptions options;
+
+  int listenFd = -1;
+  // Workers write a byte here to wake the poll thread.
+  int wakeFds[2] = {-1, -1};
+  std::thread poller;
+  std::vector<std::thread> workers;
+
+  std::mutex queueLock;
+  std::condition_variable queueReady;
+  // Connections with a request waiting, for the workers.
+  std::deque<int> pending;
+  // Connections whose request was answered, for the poll thread.
+  std::vector<int> returned;
+  bool stopping = false;
+
+  // LRU list of graph keys, most recent first, and the index into it.
+  std::mutex cacheLock;
+  std::list<std::pair<std::string, std::shared_ptr<CachedGraph>>> lru;
+  std::unordered_map<std::string, decltype(lru)::iterator> cache;
+
+  std::atomic<unsigned long> served{0};
+  std::atomic<unsigned long> hits{0};
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+   AllocatorContext.cpp
+
+   See AllocatorContext.hpp.
+
+*/
+
+#include "AllocatorContext.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "CSVReader.hpp"
+#include "ExactColoring.hpp"
+#include "GraphClass.hpp"
+#include "LocalSearch.hpp"
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+bool sameBudget(const SearchBudget &a, const SearchBudget &b) {
+  return a.time == b.time && a.iterations == b.iterations;
+}
+
+IndexedGraph relabeledGraph(const InterferenceGraph<Variable> &ig,
+                            VertexOrder vertex_order) {
+  const IndexedGraph graph(ig);
+  if (vertex_order == VertexOrder::Original) {
+    return graph;
+  }
+  return graph.relabeled(vertexOrder(graph, vertex_order));
+}
+
+Register registersUsed(const std::vector<Register> &colors) {
+  Register used = 0;
+  for (const auto c : colors) {
+    used = std::max(used, c);
+  }
+  return used;
+}
+
+};  // namespace
+
+AllocatorContext::AllocatorContext(const InterferenceGraph<Variable> &ig,
+                                   VertexOrder vertex_order)
+    : indexed(relabeledGraph(ig, vertex_order)),
+      maxDegree(ig.getMaxDegree()) {}
+
+AllocatorContext::AllocatorContext(const std::string &path_to_graph,
+                                   VertexOrder vertex_order)
+    : AllocatorContext(CSVReader::loadPipelined(path_to_graph),
+                       vertex_order) {}
+
+void AllocatorContext::colorGreedy() {
+  if (order.size() != indexed.size()) {
+    order.resize(indexed.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](Id a, Id b) {
+      return indexed.degree(a) > indexed.degree(b);
+    });
+  }
+
+  colors.assign(indexed.size(), 0);
+  // lastSeen[c] == v + 1 means register c is used by a neighbor of v.
+  lastSeen.assign(static_cast<std::size_t>(indexed.size()) + 2, 0);
+  for (const auto v : order) {
+    indexed.forEachNeighbor(
+        v, [this, v](Id w) { lastSeen[colors[w]] = v + 1; });
+    Register c = 1;
+    while (lastSeen[c] == v + 1) {
+      c++;
+    }
+    colors[v] = c;
+  }
+}
+
+RegisterAssignment AllocatorContext::assignRegisters(
+    int num_registers, Engine engine, const SearchBudget &budget) {
+  if (num_registers < 0) {
+    return {};
+  }
+  // Welsh-Powell based engines promise at most d(G) + 1 registers, so
+  // they fail below that just like the file-based overloads.
+  if ((engine == Engine::WelshPowell || engine == Engine::LocalSearch) &&
+      maxDegree + 1 > static_cast<unsigned>(num_registers)) {
+    return {};
+  }
+
+  // Only the search engines depend on the budget.
+  const bool searches =
+      engine == Engine::LocalSearch || engine == Engine::Exact;
+  Cached &cached = cacheFor(engine);
+  if (!cached.valid || (searches && !sameBudget(cached.budget, budget))) {
+    switch (engine) {
+      case Engine::Exact: {
+        ExactResult result = exactColoring(indexed, budget);
+        colors = std::move(result.colors);
+        break;
+      }
+      case Engine::Auto:
+        colors = colorByClass(indexed).colors;
+        break;
+      case Engine::LocalSearch:
+        colorGreedy();
+        colors = improveColoring(indexed, std::move(colors), budget);
+        break;
+      case Engine::WelshPowell:
+      default:
+        colorGreedy();
+        break;
+    }
+    cached.valid = true;
+    cached.budget = budget;
+    cached.numRegisters = registersUsed(colors);
+    cached.assignment = indexed.toAssignment(colors);
+  }
+
+  if (cached.numRegisters > num_registers) {
+    return {};
+  }
+  return cached.assignment;
+}
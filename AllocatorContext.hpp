@@ -0,0 +1,85 @@
+/**
+   AllocatorContext.hpp
+
+   Reusable allocation state for one graph, for callers that ask for
+   several register counts (or engines) on the same graph. The graph is
+   loaded and indexed once. The degree order, the greedy scratch buffer
+   and each engine's coloring are then kept between calls.
+
+   None of the engines' colorings depend on num_registers; only the
+   "does it fit" check does. So after the first call for an engine, a
+   call with another register count is a comparison and a copy of the
+   cached assignment. A call with a different SearchBudget recomputes
+   that engine's coloring.
+
+   The graph is relabeled with a VertexOrder (Reverse Cuthill-McKee
+   unless the caller asks otherwise) before anything is colored, so every
+   engine walks neighbor ids that sit close together. Names travel with
+   their vertices, so the assignments still name the original variables.
+
+   Results follow the same rules as the matching proj6::assignRegisters
+   overloads: an empty map if the coloring does not fit.
+
+*/
+
+#ifndef ALLOCATOR_CONTEXT_H
+#define ALLOCATOR_CONTEXT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "IndexedGraph.hpp"
+#include "InterferenceGraph.hpp"
+#include "VertexOrder.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+class AllocatorContext {
+ public:
+  explicit AllocatorContext(
+      const InterferenceGraph<Variable> &ig,
+      VertexOrder vertex_order = VertexOrder::ReverseCuthillMcKee);
+
+  // Loads the graph file once, throwing like CSVReader::load.
+  explicit AllocatorContext(
+      const std::string &path_to_graph,
+      VertexOrder vertex_order = VertexOrder::ReverseCuthillMcKee);
+
+  RegisterAssignment assignRegisters(int num_registers,
+                                     Engine engine = Engine::WelshPowell,
+                                     const SearchBudget &budget = {});
+
+  // The relabeled graph the engines color.
+  const IndexedGraph &graph() const noexcept { return indexed; }
+
+ private:
+  struct Cached {
+    bool valid = false;
+    SearchBudget budget;
+    RegisterAssignment assignment;
+    Register numRegisters = 0;
+  };
+
+  // Largest-degree-first greedy into `colors`, using the cached order.
+  void colorGreedy();
+
+  Cached &cacheFor(Engine engine) {
+    return cache[static_cast<std::size_t>(engine)];
+  }
+
+  IndexedGraph indexed;
+  unsigned maxDegree = 0;
+
+  // Computed on first use.
+  std::vector<IndexedGraph::Id> order;
+
+  std::vector<Register> colors;
+  std::vector<IndexedGraph::Id> lastSeen;
+
+  // One entry per Engine.
+  Cached cache[static_cast<std::size_t>(Engine::Auto) + 1];
+};
+
+#endif
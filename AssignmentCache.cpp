@@ -0,0 +1,368 @@
+/**
+   AssignmentCache.cpp
+
+   See AssignmentCache.hpp for the keying and eviction policy.
+
+   Entry file layout (all integers are LEB128 varints unless noted):
+
+     "RAC1"                 4 bytes magic
+     key.high, key.low      2 x 8 bytes, little endian
+     count
+     count x { name length, name bytes, register }
+
+*/
+
+#include "AssignmentCache.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "InputFile.hpp"
+#include "Varint.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char MAGIC[4] = {'R', 'A', 'C', '1'};
+
+const std::size_t KEY_BLOCK_BYTES = 64 * 1024;
+
+// Numbers the temporary files of the stores in this process.
+std::atomic<unsigned long> temporaryCount{0};
+
+// Streaming SipHash-2-4 with a 64-bit result.
+class SipHasher {
+ public:
+  SipHasher(std::uint64_t k0, std::uint64_t k1)
+      : v0(k0 ^ 0x736f6d6570736575ULL),
+        v1(k1 ^ 0x646f72616e646f6dULL),
+        v2(k0 ^ 0x6c7967656e657261ULL),
+        v3(k1 ^ 0x7465646279746573ULL) {}
+
+  void bytes(const char *data, std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+      tail |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i]))
+              << (8 * (length % 8));
+      length++;
+      if (length % 8 == 0) {
+        compress(tail);
+        tail = 0;
+      }
+    }
+  }
+
+  std::uint64_t finish() const {
+    SipHasher last = *this;
+    const std::uint64_t block = tail | (length << 56);
+    last.compress(block);
+    last.v2 ^= 0xff;
+    for (int i = 0; i < 4; i++) {
+      last.round();
+    }
+    return last.v0 ^ last.v1 ^ last.v2 ^ last.v3;
+  }
+
+ private:
+  static std::uint64_t rotl(std::uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+  }
+
+  void round() {
+    v0 += v1;
+    v1 = rotl(v1, 13);
+    v1 ^= v0;
+    v0 = rotl(v0, 32);
+    v2 += v3;
+    v3 = rotl(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotl(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotl(v1, 17);
+    v1 ^= v2;
+    v2 = rotl(v2, 32);
+  }
+
+  void compress(std::uint64_t m) {
+    v3 ^= m;
+    round();
+    round();
+    v0 ^= m;
+  }
+
+  std::uint64_t v0;
+  std::uint64_t v1;
+  std::uint64_t v2;
+  std::uint64_t v3;
+  std::uint64_t tail = 0;
+  std::uint64_t length = 0;
+};
+
+// The 128-bit key is two SipHash passes under unrelated keys, so the
+// halves are independent of each other.
+class KeyHasher {
+ public:
+  void bytes(const char *data, std::size_t size) {
+    high.bytes(data, size);
+    low.bytes(data, size);
+  }
+
+  void number(std::uint64_t n) {
+    char buffer[8];
+    for (int i = 0; i < 8; i++) {
+      buffer[i] = static_cast<char>(n >> (8 * i));
+    }
+    bytes(buffer, sizeof(buffer));
+  }
+
+  // Length prefixed so that ("ab", "c") and ("a", "bc") hash differently.
+  void string(const std::string &s) {
+    number(s.size());
+    bytes(s.data(), s.size());
+  }
+
+  CacheKey key() const { return {high.finish(), low.finish()}; }
+
+ private:
+  SipHasher high{0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+  SipHasher low{0xa4093822299f31d0ULL, 0x082efa98ec4e6c89ULL};
+};
+
+void writeFixed(std::string &out, std::uint64_t n) {
+  for (int i = 0; i < 8; i++) {
+    out.push_back(static_cast<char>(n >> (8 * i)));
+  }
+}
+
+std::uint64_t readFixed(const std::string &in, std::size_t pos) {
+  std::uint64_t n = 0;
+  for (int i = 0; i < 8; i++) {
+    n |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[pos + i]))
+         << (8 * i);
+  }
+  return n;
+}
+
+};  // namespace
+
+std::string CacheKey::hex() const {
+  const char *digits = "0123456789abcdef";
+  std::string out;
+  for (const auto half : {high, low}) {
+    for (int shift = 60; shift >= 0; shift -= 4) {
+      out.push_back(digits[(half >> shift) & 0xf]);
+    }
+  }
+  return out;
+}
+
+AssignmentCache::AssignmentCache(const std::string &directory,
+                                 std::uintmax_t max_bytes,
+                                 std::uintmax_t max_entry_bytes)
+    : directory(directory),
+      maxBytes(max_bytes),
+      maxEntryBytes(std::min(max_entry_bytes, max_bytes)) {
+  std::error_code error;
+  fs::create_directories(directory, error);
+  evict();
+}
+
+CacheKey AssignmentCache::keyFor(const std::string &path_to_graph,
+                                 int num_registers, Engine engine,
+                                 const SearchBudget &budget) {
+  InputFile file(path_to_graph);
+
+  KeyHasher hasher;
+  hasher.number(static_cast<std::uint64_t>(num_registers));
+  hasher.number(static_cast<std::uint64_t>(engine));
+  if (engine == Engine::LocalSearch || engine == Engine::Exact) {
+    hasher.number(static_cast<std::uint64_t>(budget.time.count()));
+    hasher.number(budget.iterations);
+  }
+  // The file goes last, so it needs no length prefix.
+  std::vector<char> buffer(KEY_BLOCK_BYTES);
+  while (const std::size_t got = file.read(buffer.data(), buffer.size())) {
+    hasher.bytes(buffer.data(), got);
+  }
+  return hasher.key();
+}
+
+CacheKey AssignmentCache::contentKey(const std::string &bytes) {
+  KeyHasher hasher;
+  hasher.string(bytes);
+  return hasher.key();
+}
+
+std::string AssignmentCache::entryPath(const CacheKey &key) const {
+  return (fs::path(directory) / (key.hex() + ".rac")).string();
+}
+
+bool AssignmentCache::lookup(const CacheKey &key,
+                             RegisterAssignment &assignment) const {
+  const auto path = entryPath(key);
+  std::ifstream in(path, std::ios::binary);
+  if (!in.good()) {
+    return false;
+  }
+  const std::string data((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+
+  const std::size_t header = sizeof(MAGIC) + 16;
+  if (data.size() < header || !std::equal(MAGIC, MAGIC + 4, data.begin()) ||
+      readFixed(data, 4) != key.high || readFixed(data, 12) != key.low) {
+    return false;
+  }
+
+  std::size_t pos = header;
+  std::uint64_t count = 0;
+  if (!readVarint(data, pos, count)) {
+    return false;
+  }
+  RegisterAssignment result;
+  result.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(
+      count, data.size())));
+  for (std::uint64_t i = 0; i < count; i++) {
+    std::uint64_t length = 0;
+    std::uint64_t reg = 0;
+    if (!readVarint(data, pos, length) || length > data.size() - pos) {
+      return false;
+    }
+    Variable name = data.substr(pos, static_cast<std::size_t>(length));
+    pos += static_cast<std::size_t>(length);
+    if (!readVarint(data, pos, reg)) {
+      return false;
+    }
+    result[std::move(name)] = static_cast<Register>(reg);
+  }
+
+  // Mark the entry as recently used for eviction.
+  std::error_code error;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+  assignment = std::move(result);
+  return true;
+}
+
+void AssignmentCache::store(const CacheKey &key,
+                            const RegisterAssignment &assignment) {
+  std::string data(MAGIC, sizeof(MAGIC));
+  writeFixed(data, key.high);
+  writeFixed(data, key.low);
+  writeVarint(data, assignment.size());
+  for (const auto &[name, reg] : assignment) {
+    writeVarint(data, name.size());
+    data += name;
+    writeVarint(data, static_cast<std::uint64_t>(reg));
+  }
+  if (data.size() > maxEntryBytes) {
+    return;
+  }
+
+  // Write to a temporary name first so readers never see half an entry.
+  // The name is unique to this writer (process id and a counter), so two
+  // stores of the same key never write into the same file.
+  const auto path = entryPath(key);
+  const auto temporary = path + "." + std::to_string(getpid()) + "." +
+                         std::to_string(temporaryCount++) + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+      return;
+    }
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out.good()) {
+      return;
+    }
+  }
+  // An entry replaced under the same key no longer counts.
+  std::error_code error;
+  std::uintmax_t replaced = fs::file_size(path, error);
+  if (error) {
+    replaced = 0;
+  }
+  fs::rename(temporary, path, error);
+  if (error) {
+    fs::remove(temporary, error);
+    return;
+  }
+  totalBytes = totalBytes - std::min(totalBytes, replaced) + data.size();
+  if (totalBytes > maxBytes) {
+    evict(path);
+  }
+}
+
+void AssignmentCache::evict(const std::string &keep) {
+  struct Entry {
+    fs::path path;
+    fs::file_time_type used;
+    std::uintmax_t size;
+  };
+
+  std::error_code error;
+  std::vector<Entry> entries;
+  std::uintmax_t total = 0;
+  for (fs::directory_iterator it(directory, error), end; !error && it != end;
+       it.increment(error)) {
+    if (it->path().extension() != ".rac") {
+      continue;
+    }
+    std::error_code entryError;
+    const auto size = it->file_size(entryError);
+    const auto used = it->last_write_time(entryError);
+    if (!entryError) {
+      entries.push_back({it->path(), used, size});
+      total += size;
+    }
+  }
+  totalBytes = total;
+  if (total <= maxBytes) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.used < b.used; });
+  for (const auto &entry : entries) {
+    if (total <= maxBytes) {
+      break;
+    }
+    if (entry.path == fs::path(keep)) {
+      continue;
+    }
+    if (fs::remove(entry.path, error)) {
+      total -= entry.size;
+    }
+  }
+  totalBytes = total;
+}
+
+RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
+                                          int num_registers, Engine engine,
+                                          const SearchBudget &budget,
+                                          AssignmentCache &cache) noexcept {
+  CacheKey key;
+  try {
+    key = AssignmentCache::keyFor(path_to_graph, num_registers, engine,
+                                  budget);
+  } catch (const std::exception &) {
+    return {};
+  }
+
+  RegisterAssignment assignment;
+  if (cache.lookup(key, assignment)) {
+    return assignment;
+  }
+
+  assignment = assignRegisters(path_to_graph, num_registers, engine, budget);
+  cache.store(key, assignment);
+  return assignment;
+}
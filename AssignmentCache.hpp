@@ -0,0 +1,92 @@
+/**
+   AssignmentCache.hpp
+
+   Optional on-disk cache of register assignments, for builds that keep
+   asking for the same allocation (incremental rebuilds, trying several
+   register counts).
+
+   Entries are content addressed: the key is a 128-bit hash (two SipHash
+   passes under different keys) of the graph file's bytes, decompressed
+   if the file is compressed, together with num_registers, the engine and,
+   for the engines that use one, the SearchBudget. The file is only
+   hashed, never parsed, so a hit costs one read of the file. A file
+   with its rows reordered is a different key. Each entry is one
+   small binary file in the cache directory named after its key. The
+   cache keeps a running total of the entry sizes; when it grows past
+   `max_bytes`, the directory is rescanned and the least recently used
+   entries (by file modification time, refreshed on every hit) are
+   deleted.
+
+   The cache never makes an allocation fail: unreadable or corrupt entries
+   count as misses and write errors are ignored.
+
+*/
+
+#ifndef ASSIGNMENT_CACHE_H
+#define ASSIGNMENT_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "proj6.hpp"
+
+using namespace proj6;
+
+struct CacheKey {
+  std::uint64_t high = 0;
+  std::uint64_t low = 0;
+
+  std::string hex() const;
+};
+
+class AssignmentCache {
+ public:
+  // Entries larger than max_entry_bytes are never stored.
+  explicit AssignmentCache(const std::string &directory,
+                           std::uintmax_t max_bytes = 64 * 1024 * 1024,
+                           std::uintmax_t max_entry_bytes = 4 * 1024 * 1024);
+
+  // Hashes the graph file without parsing it. Throws std::runtime_error
+  // if the file cannot be read. The budget is only part of the key for
+  // LocalSearch and Exact.
+  static CacheKey keyFor(const std::string &path_to_graph, int num_registers,
+                         Engine engine, const SearchBudget &budget = {});
+
+  // 128-bit hash of bytes already in memory.
+  static CacheKey contentKey(const std::string &bytes);
+
+  bool lookup(const CacheKey &key, RegisterAssignment &assignment) const;
+
+  void store(const CacheKey &key, const RegisterAssignment &assignment);
+
+ private:
+  std::string entryPath(const CacheKey &key) const;
+
+  // Rescans the directory to refresh totalBytes, then deletes the least
+  // recently used entries until it is at most maxBytes. The entry at
+  // `keep` (the one just stored) is never deleted; modification times
+  // are too coarse to tell it from an entry written just before.
+  void evict(const std::string &keep = "");
+
+  std::string directory;
+  std::uintmax_t maxBytes;
+  std::uintmax_t maxEntryBytes;
+
+  // Bytes of all entries, as of the last directory scan plus the stores
+  // since.
+  std::uintmax_t totalBytes = 0;
+};
+
+namespace proj6 {
+
+// assignRegisters with the given engine, going through `cache`. A hit
+// skips loading, ordering and coloring entirely. Returns an empty map if
+// the graph file cannot be read.
+RegisterAssignment assignRegisters(const std::string &path_to_graph,
+                                   int num_registers, Engine engine,
+                                   const SearchBudget &budget,
+                                   AssignmentCache &cache) noexcept;
+
+};  // namespace proj6
+
+#endif
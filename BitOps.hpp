@@ -0,0 +1,39 @@
+/**
+   BitOps.hpp
+
+   Portable popcount / count-trailing-zeros for 64-bit words, used by the
+   bitset based code (ExactColoring.cpp and the register masks in
+   proj6.cpp). GCC and Clang get the builtins, everything else a plain
+   loop.
+
+*/
+
+#ifndef BIT_OPS_H
+#define BIT_OPS_H
+
+#include <bitset>
+#include <cstdint>
+
+inline unsigned popcount(std::uint64_t w) {
+#if defined(__GNUC__)
+  return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+  return static_cast<unsigned>(std::bitset<64>(w).count());
+#endif
+}
+
+// Index of the lowest set bit; `w` must not be zero.
+inline unsigned lowestBit(std::uint64_t w) {
+#if defined(__GNUC__)
+  return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+  unsigned bit = 0;
+  while ((w & 1) == 0) {
+    w >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+#endif
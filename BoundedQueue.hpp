@@ -0,0 +1,76 @@
+/**
+   BoundedQueue.hpp
+
+   Fixed-capacity lock-free queue for exactly one producer thread and one
+   consumer thread. The producer only writes `tail` and the consumer only
+   writes `head`, so a pair of acquire/release atomics is all the
+   synchronization needed. push/pop spin (yielding the CPU) while the
+   queue is full/empty, which bounds memory use when one side is faster.
+
+*/
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class BoundedQueue {
+ public:
+  // `capacity` is rounded up to a power of two.
+  explicit BoundedQueue(std::size_t capacity) : head(0), tail(0) {
+    std::size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots.resize(size);
+    mask = size - 1;
+  }
+
+  bool tryPush(T &item) {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == slots.size()) {
+      return false;
+    }
+    slots[t & mask] = std::move(item);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool tryPop(T &item) {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    item = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  void push(T item) {
+    while (!tryPush(item)) {
+      std::this_thread::yield();
+    }
+  }
+
+  T pop() {
+    T item;
+    while (!tryPop(item)) {
+      std::this_thread::yield();
+    }
+    return item;
+  }
+
+ private:
+  std::vector<T> slots;
+  std::size_t mask;
+  // Kept on separate cache lines so the two threads do not false-share.
+  alignas(64) std::atomic<std::size_t> head;
+  alignas(64) std::atomic<std::size_t> tail;
+};
+
+#endif
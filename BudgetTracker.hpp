@@ -0,0 +1,49 @@
+/**
+   BudgetTracker.hpp
+
+   Small helper shared by the search-based engines (LocalSearch.cpp,
+   ExactColoring.cpp) to keep track of how much of a SearchBudget has been
+   used. Each call to exhausted() counts as one step (a tabu move, a
+   branch-and-bound node, ...). The clock is only read every 64 steps
+   since now() is far more expensive than a single step.
+
+*/
+
+#ifndef BUDGET_TRACKER_H
+#define BUDGET_TRACKER_H
+
+#include <chrono>
+
+#include "proj6.hpp"
+
+class BudgetTracker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit BudgetTracker(const proj6::SearchBudget &budget)
+      : maxIterations(budget.iterations),
+        timed(budget.time.count() > 0),
+        deadline(Clock::now() + budget.time) {}
+
+  bool exhausted() {
+    iterations++;
+    if (maxIterations != 0 && iterations > maxIterations) {
+      return true;
+    }
+    if (timed && !expired && (iterations & 63) == 0) {
+      expired = Clock::now() >= deadline;
+    }
+    return expired;
+  }
+
+  unsigned long steps() const noexcept { return iterations; }
+
+ private:
+  unsigned long maxIterations;
+  unsigned long iterations = 0;
+  bool timed;
+  bool expired = false;
+  Clock::time_point deadline;
+};
+
+#endif
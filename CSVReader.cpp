@@ -9,14 +9,140 @@
 
 #include "CSVReader.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "BoundedQueue.hpp"
+#include "InputFile.hpp"
 #include "InterferenceGraph.hpp"
 
+namespace {
+
+const std::size_t PIPELINE_BLOCK_BYTES = 64 * 1024;
+const std::size_t PIPELINE_QUEUE_BLOCKS = 8;
+
+// A batch of tokenized rows handed from the reader thread to the builder.
+// Row i has widths[i] cells, stored back to back in `cells`.
+struct RowBlock {
+  std::vector<std::string> cells;
+  std::vector<unsigned char> widths;
+  bool last = false;
+  std::exception_ptr error;
+};
+
+// Splits one line exactly like readRow(): cells are separated by ',' and a
+// trailing empty cell is dropped.
+void tokenizeLine(const char *begin, const char *end, RowBlock &block) {
+  std::size_t width = 0;
+  const char *cell = begin;
+  for (const char *p = begin; p != end; ++p) {
+    if (*p == ',') {
+      block.cells.emplace_back(cell, p);
+      width++;
+      cell = p + 1;
+    }
+  }
+  if (cell != end) {
+    block.cells.emplace_back(cell, end);
+    width++;
+  }
+  // Anything over 2 is an error; keep the real count up to 255 for it.
+  block.widths.push_back(
+      static_cast<unsigned char>(std::min<std::size_t>(width, 255)));
+}
+
+// Splits chunks of the file into complete lines. A partial line at the
+// end of a chunk is carried over to the next one.
+class LineSplitter {
+ public:
+  void split(const char *begin, const char *end, RowBlock &block) {
+    const char *start = begin;
+    for (const char *p = begin; p != end; ++p) {
+      if (*p != '\n') {
+        continue;
+      }
+      if (!carry.empty()) {
+        carry.append(start, p);
+        tokenizeLine(carry.data(), carry.data() + carry.size(), block);
+        carry.clear();
+      } else {
+        tokenizeLine(start, p, block);
+      }
+      start = p + 1;
+    }
+    carry.append(start, end);
+  }
+
+  // Tokenizes the last line if the file does not end in a newline.
+  void finish(RowBlock &block) {
+    if (!carry.empty()) {
+      tokenizeLine(carry.data(), carry.data() + carry.size(), block);
+    }
+    block.last = true;
+  }
+
+ private:
+  std::string carry;
+};
+
+// Adds the rows of `block` to `ig`. Returns false, having stopped, at the
+// first row with more than two cells.
+bool insertRows(const RowBlock &block, InterferenceGraph<Variable> &ig) {
+  std::size_t cell = 0;
+  for (const auto width : block.widths) {
+    if (width > 2) {
+      return false;
+    }
+    for (unsigned j = 0; j < width; j++) {
+      ig.addVertex(block.cells[cell + j]);
+    }
+    if (width == 2) {
+      ig.addEdge(block.cells[cell], block.cells[cell + 1]);
+    }
+    cell += width;
+  }
+  return true;
+}
+
+// Reader thread body: reads (and decompresses) the file in
+// PIPELINE_BLOCK_BYTES chunks, splits complete lines into a RowBlock and
+// queues it.
+void readBlocks(InputFile &file, BoundedQueue<RowBlock> &queue) {
+  std::vector<char> buffer(PIPELINE_BLOCK_BYTES);
+  LineSplitter splitter;
+  try {
+    for (;;) {
+      const std::size_t got = file.read(buffer.data(), buffer.size());
+      if (got == 0) {
+        break;
+      }
+
+      RowBlock block;
+      splitter.split(buffer.data(), buffer.data() + got, block);
+      queue.push(std::move(block));
+    }
+
+    RowBlock block;
+    splitter.finish(block);
+    queue.push(std::move(block));
+  } catch (...) {
+    RowBlock block;
+    block.last = true;
+    block.error = std::current_exception();
+    queue.push(std::move(block));
+  }
+}
+
+};  // namespace
+
 std::vector<std::string> CSVReader::readRow(std::string &s) {
   std::vector<std::string> row = {};
 
@@ -56,4 +182,130 @@ InterferenceGraph<Variable> CSVReader::load(const std::string &graph_path) {
 
   // Note: copy constructor not needed due to copy ellision.
   return ig;
-}
\ No newline at end of file
+}
+
+InterferenceGraph<Variable> CSVReader::loadPipelined(
+    const std::string &graph_path) {
+  InputFile file(graph_path);
+  InterferenceGraph<Variable> ig;
+  bool badRow = false;
+
+  // A file that fits in one block gains nothing from a reader thread, and
+  // most graphs (one per function) are that small. Read it here in a
+  // buffer of its own size. The size on disk is only a hint for
+  // compressed files; the loop reads until the end either way.
+  std::error_code sizeError;
+  const auto fileSize = std::filesystem::file_size(graph_path, sizeError);
+  if (!sizeError && fileSize < PIPELINE_BLOCK_BYTES) {
+    std::vector<char> buffer(static_cast<std::size_t>(fileSize) + 1);
+    LineSplitter splitter;
+    for (;;) {
+      RowBlock block;
+      const std::size_t got = file.read(buffer.data(), buffer.size());
+      if (got == 0) {
+        splitter.finish(block);
+      } else {
+        splitter.split(buffer.data(), buffer.data() + got, block);
+      }
+      if (!insertRows(block, ig)) {
+        badRow = true;
+        break;
+      }
+      if (got == 0) {
+        break;
+      }
+    }
+  } else {
+    BoundedQueue<RowBlock> queue(PIPELINE_QUEUE_BLOCKS);
+    std::thread reader(readBlocks, std::ref(file), std::ref(queue));
+
+    // Nothing may leave this loop before the reader has pushed its last
+    // block: after a bad row or an exception from the graph (bad_alloc,
+    // say) keep draining so the reader never blocks on a full queue, and
+    // the thread is joined before anything is rethrown.
+    std::exception_ptr error;
+    while (true) {
+      RowBlock block = queue.pop();
+      if (block.error && !error) {
+        error = block.error;
+      }
+      if (!badRow && !error) {
+        try {
+          badRow = !insertRows(block, ig);
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+      if (block.last) {
+        break;
+      }
+    }
+    reader.join();
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  if (badRow) {
+    throw std::runtime_error(
+        "Graph contains row with more than two vertices: " + graph_path);
+  }
+  return ig;
+}
+
+CompactInterferenceGraph<Variable> CSVReader::loadCompact(
+    const std::string &graph_path) {
+  CompactInterferenceGraph<Variable> ig;
+  std::string line;
+  InputFile file(graph_path);
+
+  while (file.readLine(line)) {
+    const auto &row = readRow(line);
+    if (row.size() > 2) {
+      throw std::runtime_error(
+          "Graph contains row with more than two vertices: " + graph_path);
+    }
+
+    for (const auto &v : row) {
+      ig.addVertex(v);
+    }
+
+    if (row.size() == 2) {
+      ig.addEdge(row.at(0), row.at(1));
+    }
+  }
+
+  ig.shrinkToFit();
+  return ig;
+}
+
+std::vector<LiveInterval> CSVReader::loadIntervals(
+    const std::string &intervals_path) {
+  std::vector<LiveInterval> intervals;
+  std::string line;
+  InputFile file(intervals_path);
+
+  while (file.readLine(line)) {
+    const auto &row = readRow(line);
+    if (row.empty()) {
+      continue;
+    }
+    if (row.size() != 3) {
+      throw std::runtime_error(
+          "Interval file contains row without exactly three fields: " +
+          intervals_path);
+    }
+
+    try {
+      intervals.push_back({row.at(0),
+                           static_cast<unsigned>(std::stoul(row.at(1))),
+                           static_cast<unsigned>(std::stoul(row.at(2)))});
+    } catch (const std::logic_error &) {
+      throw std::runtime_error("Interval file contains a bad position: " +
+                               intervals_path);
+    }
+  }
+
+  return intervals;
+}
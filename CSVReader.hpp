@@ -13,7 +13,9 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "CompactInterferenceGraph.hpp"
 #include "InterferenceGraph.hpp"
 #include "proj6.hpp"
 
@@ -34,6 +36,25 @@ class CSVReader {
   // line by line, adding each edge to this InterferenceGraph.
   // See the README for an example.
   static InterferenceGraph<Variable> load(const std::string &graph_path);
+
+  // Same result as load(), but a second thread reads and tokenizes the
+  // file in blocks while this thread inserts the edges, so file I/O
+  // overlaps graph construction. Files smaller than one block are read on
+  // this thread alone. The file may be gzip (or zstd)
+  // compressed; see InputFile.hpp.
+  static InterferenceGraph<Variable> loadPipelined(
+      const std::string &graph_path);
+
+  // Same as load() but builds the low-footprint CompactInterferenceGraph
+  // directly, without an InterferenceGraph in between. Accepts compressed
+  // files like loadPipelined().
+  static CompactInterferenceGraph<Variable> loadCompact(
+      const std::string &graph_path);
+
+  // Reads a live-interval file where every row is "variable,start,end".
+  // Accepts compressed files like loadPipelined().
+  static std::vector<LiveInterval> loadIntervals(
+      const std::string &intervals_path);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,321 @@
+/**
+   Coalescing.cpp
+
+   See Coalescing.hpp. The merged graph is kept as one sorted neighbor
+   list of union-find roots per root, like CompactInterferenceGraph, so
+   the Briggs and George tests are merges and binary searches over
+   integers.
+
+*/
+
+#include "Coalescing.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "CSVReader.hpp"
+#include "GreedyColoring.hpp"
+#include "InputFile.hpp"
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+// Union-find with path halving and union by size.
+class DisjointSets {
+ public:
+  explicit DisjointSets(Id size) : parent(size), sizes(size, 1) {
+    for (Id v = 0; v < size; v++) {
+      parent[v] = v;
+    }
+  }
+
+  Id find(Id v) {
+    while (parent[v] != v) {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+    return v;
+  }
+
+  // Returns the root of the merged set.
+  Id unite(Id a, Id b) {
+    if (sizes[a] < sizes[b]) {
+      std::swap(a, b);
+    }
+    parent[b] = a;
+    sizes[a] += sizes[b];
+    return a;
+  }
+
+  std::vector<Id> roots() {
+    std::vector<Id> result(parent.size());
+    for (Id v = 0; v < parent.size(); v++) {
+      result[v] = find(v);
+    }
+    return result;
+  }
+
+ private:
+  std::vector<Id> parent;
+  std::vector<Id> sizes;
+};
+
+class Coalescer {
+ public:
+  Coalescer(const IndexedGraph &graph, int num_registers)
+      : sets(graph.size()),
+        adjacency(graph.size()),
+        k(static_cast<std::size_t>(std::max(num_registers, 0))) {
+    for (Id v = 0; v < graph.size(); v++) {
+      // CSR lists are sorted already; only self-loops need to go.
+      graph.forEachNeighbor(v, [this, v](Id w) {
+        if (w != v) {
+          adjacency[v].push_back(w);
+        }
+      });
+    }
+  }
+
+  // Tries to merge the two sets. Returns true if they are (now) merged.
+  bool tryMerge(Id a, Id b) {
+    a = sets.find(a);
+    b = sets.find(b);
+    if (a == b) {
+      return true;
+    }
+    if (interferes(a, b) || !(briggs(a, b) || george(a, b) || george(b, a))) {
+      return false;
+    }
+
+    const Id root = sets.unite(a, b);
+    const Id gone = root == a ? b : a;
+    for (const auto t : adjacency[gone]) {
+      eraseSorted(adjacency[t], gone);
+      insertSorted(adjacency[t], root);
+    }
+    std::vector<Id> merged;
+    merged.reserve(adjacency[root].size() + adjacency[gone].size());
+    std::set_union(adjacency[root].begin(), adjacency[root].end(),
+                   adjacency[gone].begin(), adjacency[gone].end(),
+                   std::back_inserter(merged));
+    adjacency[root] = std::move(merged);
+    adjacency[gone] = std::vector<Id>();
+    return true;
+  }
+
+  bool merged(Id a, Id b) { return sets.find(a) == sets.find(b); }
+
+  std::vector<Id> roots() { return sets.roots(); }
+
+ private:
+  bool interferes(Id a, Id b) const {
+    return std::binary_search(adjacency[a].begin(), adjacency[a].end(), b);
+  }
+
+  // Fewer than k neighbors of the merged vertex have degree >= k. A
+  // neighbor of both loses one neighbor in the merge.
+  bool briggs(Id a, Id b) const {
+    const auto &left = adjacency[a];
+    const auto &right = adjacency[b];
+    std::size_t significant = 0;
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < left.size() || j < right.size()) {
+      Id t;
+      bool both = false;
+      if (j == right.size() || (i < left.size() && left[i] < right[j])) {
+        t = left[i++];
+      } else if (i == left.size() || right[j] < left[i]) {
+        t = right[j++];
+      } else {
+        t = left[i++];
+        j++;
+        both = true;
+      }
+      if (adjacency[t].size() - (both ? 1 : 0) >= k && ++significant >= k) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Every neighbor of `b` is insignificant or already a neighbor of `a`.
+  bool george(Id a, Id b) const {
+    for (const auto t : adjacency[b]) {
+      if (adjacency[t].size() >= k && !interferes(a, t)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void insertSorted(std::vector<Id> &list, Id id) {
+    const auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it == list.end() || *it != id) {
+      list.insert(it, id);
+    }
+  }
+
+  static void eraseSorted(std::vector<Id> &list, Id id) {
+    const auto it = std::lower_bound(list.begin(), list.end(), id);
+    if (it != list.end() && *it == id) {
+      list.erase(it);
+    }
+  }
+
+  DisjointSets sets;
+  std::vector<std::vector<Id>> adjacency;
+  std::size_t k;
+};
+
+// The graph with every union-find set contracted to one vertex, in the
+// form largestFirstColoring expects.
+class ContractedGraph {
+ public:
+  ContractedGraph(const IndexedGraph &graph,
+                  const std::vector<Id> &representative)
+      : vertexOf(graph.size()) {
+    std::vector<Id> compact(graph.size(), NONE);
+    Id count = 0;
+    for (Id v = 0; v < graph.size(); v++) {
+      Id &slot = compact[representative[v]];
+      if (slot == NONE) {
+        slot = count++;
+      }
+      vertexOf[v] = slot;
+    }
+
+    std::vector<std::vector<Id>> lists(count);
+    for (Id v = 0; v < graph.size(); v++) {
+      graph.forEachNeighbor(v, [&](Id w) {
+        if (vertexOf[v] != vertexOf[w]) {
+          lists[vertexOf[v]].push_back(vertexOf[w]);
+        }
+      });
+    }
+    offsets.push_back(0);
+    for (auto &list : lists) {
+      std::sort(list.begin(), list.end());
+      list.erase(std::unique(list.begin(), list.end()), list.end());
+      neighbors.insert(neighbors.end(), list.begin(), list.end());
+      offsets.push_back(static_cast<unsigned>(neighbors.size()));
+    }
+  }
+
+  Id size() const noexcept { return static_cast<Id>(offsets.size() - 1); }
+
+  unsigned degree(Id v) const noexcept { return offsets[v + 1] - offsets[v]; }
+
+  template <typename Visit>
+  void forEachNeighbor(Id v, Visit visit) const {
+    for (unsigned i = offsets[v]; i < offsets[v + 1]; i++) {
+      visit(neighbors[i]);
+    }
+  }
+
+  // Contracted vertex of every original id.
+  std::vector<Id> vertexOf;
+
+ private:
+  static constexpr Id NONE = ~Id(0);
+
+  std::vector<unsigned> offsets;
+  std::vector<Id> neighbors;
+};
+
+Register registersUsed(const std::vector<Register> &colors) {
+  Register used = 0;
+  for (const auto c : colors) {
+    used = std::max(used, c);
+  }
+  return used;
+}
+
+};  // namespace
+
+MoveList proj6::loadMoves(const std::string &moves_path) {
+  InputFile file(moves_path);
+  MoveList moves;
+  std::string line;
+  while (file.readLine(line)) {
+    auto row = CSVReader::readRow(line);
+    if (row.empty()) {
+      continue;
+    }
+    if (row.size() != 2) {
+      throw std::runtime_error(
+          "Move file contains row without exactly two variables: " +
+          moves_path);
+    }
+    moves.emplace_back(std::move(row[0]), std::move(row[1]));
+  }
+  return moves;
+}
+
+CoalesceResult proj6::coalesceMoves(
+    const IndexedGraph &graph, const std::vector<std::pair<Id, Id>> &moves,
+    int num_registers) {
+  Coalescer coalescer(graph, num_registers);
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const auto &[a, b] : moves) {
+      if (a != b && !coalescer.merged(a, b) && coalescer.tryMerge(a, b)) {
+        changed = true;
+      }
+    }
+  }
+
+  CoalesceResult result;
+  result.representative = coalescer.roots();
+  for (const auto &[a, b] : moves) {
+    if (a != b && result.representative[a] == result.representative[b]) {
+      result.coalescedMoves++;
+    }
+  }
+  return result;
+}
+
+RegisterAssignment proj6::assignRegisters(
+    const InterferenceGraph<Variable> &ig, int num_registers,
+    const MoveList &moves) noexcept {
+  const IndexedGraph graph(ig);
+
+  std::vector<std::pair<Id, Id>> idMoves;
+  idMoves.reserve(moves.size());
+  for (const auto &[a, b] : moves) {
+    if (graph.contains(a) && graph.contains(b)) {
+      idMoves.emplace_back(graph.id(a), graph.id(b));
+    }
+  }
+
+  const CoalesceResult coalesced =
+      coalesceMoves(graph, idMoves, num_registers);
+  const ContractedGraph contracted(graph, coalesced.representative);
+  const std::vector<Register> contractedColors =
+      largestFirstColoring(contracted);
+
+  std::vector<Register> colors(graph.size());
+  for (Id v = 0; v < graph.size(); v++) {
+    colors[v] = contractedColors[contracted.vertexOf[v]];
+  }
+  // Merged vertices can have more neighbors than any vertex of `ig`, so
+  // the merged coloring may pass the d(G) + 1 registers every
+  // assignRegisters overload promises, even when it fits num_registers.
+  const long limit = std::min<long>(num_registers, ig.getMaxDegree() + 1L);
+  if (registersUsed(colors) > limit) {
+    colors = largestFirstColoring(graph);
+    if (registersUsed(colors) > num_registers) {
+      return {};
+    }
+  }
+  return graph.toAssignment(colors);
+}
+
+RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
+                                          int num_registers,
+                                          const MoveList &moves) noexcept {
+  return assignRegisters(CSVReader::loadPipelined(path_to_graph),
+                         num_registers, moves);
+}
@@ -0,0 +1,80 @@
+/**
+   Coalescing.hpp
+
+   Move-aware allocation. A move (copy) "a = b" costs nothing if a and b
+   end up in the same register. If they do not interfere, the two
+   vertices can be merged (coalesced) into one before coloring, so the
+   coloring has to give them the same register.
+
+   Merging blindly can turn a colorable graph into one that is not, so
+   only conservative merges are made. A pair is merged if one of these
+   holds, with k = num_registers:
+
+     Briggs  the merged vertex has fewer than k neighbors of degree >= k.
+     George  every neighbor of one of the two either has degree < k or
+             already interferes with the other.
+
+   Merged vertices are tracked with a union-find over IndexedGraph ids.
+   The moves are tried in the order given, so the hottest moves should
+   come first. Passes repeat while they merge anything, since a merge
+   can lower degrees enough for a pair refused earlier.
+
+   Moves between interfering variables, moves that mention unknown
+   variables and moves from a variable to itself are ignored.
+
+*/
+
+#ifndef COALESCING_H
+#define COALESCING_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IndexedGraph.hpp"
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+namespace proj6 {
+
+// Pairs of variables connected by a move; see loadMoves for the file
+// format.
+using MoveList = std::vector<std::pair<Variable, Variable>>;
+
+struct CoalesceResult {
+  // Union-find root of every id. Ids with the same root are merged.
+  std::vector<IndexedGraph::Id> representative;
+
+  // Moves whose two variables were merged, including moves made free by
+  // earlier merges.
+  unsigned coalescedMoves = 0;
+};
+
+// Reads a move file where every row is "destination,source". Accepts
+// compressed files like CSVReader::loadPipelined.
+MoveList loadMoves(const std::string &moves_path);
+
+CoalesceResult coalesceMoves(
+    const IndexedGraph &graph,
+    const std::vector<std::pair<IndexedGraph::Id, IndexedGraph::Id>> &moves,
+    int num_registers);
+
+// Welsh-Powell coloring of the graph after coalescing `moves`, so merged
+// variables share a register. If the merged graph needs more than
+// num_registers, or more than the d(G) + 1 registers of the other
+// overloads, the graph is colored without merging instead, so the moves
+// never make an allocation fail or use more registers. Returns an empty
+// map if even that needs more than num_registers.
+RegisterAssignment assignRegisters(const InterferenceGraph<Variable> &ig,
+                                   int num_registers,
+                                   const MoveList &moves) noexcept;
+
+RegisterAssignment assignRegisters(const std::string &path_to_graph,
+                                   int num_registers,
+                                   const MoveList &moves) noexcept;
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,397 @@
+/**
+   CompactInterferenceGraph.hpp
+
+   Low-footprint variant of InterferenceGraph with the same interface.
+   Every vertex name is stored once and gets a dense 32-bit id; each
+   vertex keeps a sorted std::vector of neighbor ids, and names are looked
+   up through an open-addressing table of ids (linear probing, at most
+   half full). An edge therefore costs 8 bytes instead of two hash nodes
+   holding full copies of both names.
+
+   The price is slower mutation: adding or removing an edge shifts part of
+   a neighbor vector (O(degree)), and removing a vertex moves the last id
+   into its place, which rewrites that vertex's neighbor lists.
+
+*/
+
+#ifndef COMPACT_INTERFERENCE_GRAPH_H
+#define COMPACT_INTERFERENCE_GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "InterferenceGraph.hpp"
+#include "MemoryUsage.hpp"
+
+template <typename T>
+class CompactInterferenceGraph {
+ public:
+  using Id = std::uint32_t;
+
+  using EdgeTy = std::pair<T, T>;
+
+  CompactInterferenceGraph() = default;
+
+  explicit CompactInterferenceGraph(const InterferenceGraph<T> &ig);
+
+  void addEdge(const T &v, const T &w);
+
+  void addVertex(const T &vertex) noexcept;
+
+  void removeEdge(const T &v, const T &w);
+
+  void removeVertex(const T &vertex);
+
+  std::unordered_set<T> vertices() const noexcept;
+
+  std::unordered_set<T> neighbors(const T &vertex) const;
+
+  unsigned numVertices() const noexcept;
+
+  unsigned numEdges() const noexcept;
+
+  bool interferes(const T &v, const T &w) const;
+
+  unsigned degree(const T &v) const;
+
+  unsigned getMaxDegree() const;
+
+  std::vector<T> getVerticesSortedByDegree() const;
+
+  std::unordered_set<T> getNeighbors(const T &vertex) const;
+
+  MemoryUsage memoryUsage() const noexcept;
+
+  // Give back the spare capacity of all vectors once the graph is built.
+  void shrinkToFit();
+
+ private:
+  static constexpr Id NO_VERTEX = ~Id(0);
+
+  Id find(const T &vertex) const noexcept;
+
+  Id findOrThrow(const T &vertex) const;
+
+  Id insert(const T &vertex);
+
+  std::size_t home(const T &vertex) const noexcept {
+    return std::hash<T>{}(vertex) & (slots.size() - 1);
+  }
+
+  void rehash(std::size_t size);
+
+  void eraseSlot(std::size_t slot);
+
+  // Both return true if the list changed.
+  static bool insertSorted(std::vector<Id> &list, Id id);
+
+  static bool eraseSorted(std::vector<Id> &list, Id id);
+
+  std::vector<T> names;
+  std::vector<std::vector<Id>> adjacency;
+  std::vector<Id> slots;
+
+  // Sum of all neighbor list sizes, so every edge is counted twice.
+  std::size_t neighborEntries = 0;
+};
+
+template <typename T>
+CompactInterferenceGraph<T>::CompactInterferenceGraph(
+    const InterferenceGraph<T> &ig) {
+  for (const auto &vertex : ig.vertices()) {
+    insert(vertex);
+  }
+  for (Id v = 0; v < names.size(); v++) {
+    for (const auto &neighbor : ig.getNeighbors(names[v])) {
+      adjacency[v].push_back(find(neighbor));
+    }
+    std::sort(adjacency[v].begin(), adjacency[v].end());
+    neighborEntries += adjacency[v].size();
+  }
+  shrinkToFit();
+}
+
+template <typename T>
+typename CompactInterferenceGraph<T>::Id CompactInterferenceGraph<T>::find(
+    const T &vertex) const noexcept {
+  if (slots.empty()) {
+    return NO_VERTEX;
+  }
+  const std::size_t mask = slots.size() - 1;
+  for (std::size_t slot = home(vertex);; slot = (slot + 1) & mask) {
+    if (slots[slot] == NO_VERTEX) {
+      return NO_VERTEX;
+    }
+    if (names[slots[slot]] == vertex) {
+      return slots[slot];
+    }
+  }
+}
+
+template <typename T>
+typename CompactInterferenceGraph<T>::Id
+CompactInterferenceGraph<T>::findOrThrow(const T &vertex) const {
+  const Id id = find(vertex);
+  if (id == NO_VERTEX) {
+    throw UnknownVertexException(vertex);
+  }
+  return id;
+}
+
+template <typename T>
+typename CompactInterferenceGraph<T>::Id CompactInterferenceGraph<T>::insert(
+    const T &vertex) {
+  const Id existing = find(vertex);
+  if (existing != NO_VERTEX) {
+    return existing;
+  }
+
+  // keep the table at most half full
+  if (2 * (names.size() + 1) > slots.size()) {
+    rehash(std::max<std::size_t>(16, 2 * slots.size()));
+  }
+
+  const Id id = static_cast<Id>(names.size());
+  names.push_back(vertex);
+  adjacency.emplace_back();
+
+  std::size_t slot = home(vertex);
+  while (slots[slot] != NO_VERTEX) {
+    slot = (slot + 1) & (slots.size() - 1);
+  }
+  slots[slot] = id;
+  return id;
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::rehash(std::size_t size) {
+  slots.assign(size, NO_VERTEX);
+  for (Id id = 0; id < names.size(); id++) {
+    std::size_t slot = home(names[id]);
+    while (slots[slot] != NO_VERTEX) {
+      slot = (slot + 1) & (slots.size() - 1);
+    }
+    slots[slot] = id;
+  }
+}
+
+// Backward-shift deletion: pull later entries of the same probe run into
+// the hole so lookups never need tombstones.
+template <typename T>
+void CompactInterferenceGraph<T>::eraseSlot(std::size_t slot) {
+  const std::size_t mask = slots.size() - 1;
+  std::size_t hole = slot;
+  for (std::size_t next = (hole + 1) & mask; slots[next] != NO_VERTEX;
+       next = (next + 1) & mask) {
+    const std::size_t want = home(names[slots[next]]);
+    // move the entry if its home is not in (hole, next]
+    if (((next - want) & mask) >= ((next - hole) & mask)) {
+      slots[hole] = slots[next];
+      hole = next;
+    }
+  }
+  slots[hole] = NO_VERTEX;
+}
+
+template <typename T>
+bool CompactInterferenceGraph<T>::insertSorted(std::vector<Id> &list, Id id) {
+  const auto it = std::lower_bound(list.begin(), list.end(), id);
+  if (it != list.end() && *it == id) {
+    return false;
+  }
+  list.insert(it, id);
+  return true;
+}
+
+template <typename T>
+bool CompactInterferenceGraph<T>::eraseSorted(std::vector<Id> &list, Id id) {
+  const auto it = std::lower_bound(list.begin(), list.end(), id);
+  if (it == list.end() || *it != id) {
+    return false;
+  }
+  list.erase(it);
+  return true;
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::addVertex(const T &vertex) noexcept {
+  insert(vertex);
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::addEdge(const T &v, const T &w) {
+  const Id a = insert(v);
+  const Id b = insert(w);
+
+  if (insertSorted(adjacency[a], b)) {
+    neighborEntries++;
+  }
+  if (a != b && insertSorted(adjacency[b], a)) {
+    neighborEntries++;
+  }
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::removeEdge(const T &v, const T &w) {
+  const Id a = find(v);
+  const Id b = find(w);
+  if (a == NO_VERTEX || b == NO_VERTEX) {
+    throw UnknownEdgeException(v, w);
+  }
+
+  if (eraseSorted(adjacency[a], b)) {
+    neighborEntries--;
+  }
+  if (a != b && eraseSorted(adjacency[b], a)) {
+    neighborEntries--;
+  }
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::removeVertex(const T &vertex) {
+  const Id id = findOrThrow(vertex);
+
+  for (const auto neighbor : adjacency[id]) {
+    if (neighbor != id && eraseSorted(adjacency[neighbor], id)) {
+      neighborEntries--;
+    }
+  }
+  neighborEntries -= adjacency[id].size();
+
+  std::size_t slot = home(vertex);
+  while (slots[slot] != id) {
+    slot = (slot + 1) & (slots.size() - 1);
+  }
+  eraseSlot(slot);
+
+  // Move the last vertex into the freed id so ids stay dense.
+  const Id last = static_cast<Id>(names.size() - 1);
+  if (id != last) {
+    slot = home(names[last]);
+    while (slots[slot] != last) {
+      slot = (slot + 1) & (slots.size() - 1);
+    }
+    slots[slot] = id;
+
+    for (const auto neighbor : adjacency[last]) {
+      if (neighbor != last) {
+        eraseSorted(adjacency[neighbor], last);
+        insertSorted(adjacency[neighbor], id);
+      }
+    }
+    if (eraseSorted(adjacency[last], last)) {
+      insertSorted(adjacency[last], id);
+    }
+
+    names[id] = std::move(names[last]);
+    adjacency[id] = std::move(adjacency[last]);
+  }
+  names.pop_back();
+  adjacency.pop_back();
+}
+
+template <typename T>
+std::unordered_set<T> CompactInterferenceGraph<T>::vertices() const noexcept {
+  return std::unordered_set<T>(names.begin(), names.end());
+}
+
+template <typename T>
+std::unordered_set<T> CompactInterferenceGraph<T>::neighbors(
+    const T &vertex) const {
+  std::unordered_set<T> result;
+  const auto &list = adjacency[findOrThrow(vertex)];
+  result.reserve(list.size());
+  for (const auto neighbor : list) {
+    result.insert(names[neighbor]);
+  }
+  return result;
+}
+
+template <typename T>
+std::unordered_set<T> CompactInterferenceGraph<T>::getNeighbors(
+    const T &vertex) const {
+  return neighbors(vertex);
+}
+
+template <typename T>
+unsigned CompactInterferenceGraph<T>::numVertices() const noexcept {
+  return static_cast<unsigned>(names.size());
+}
+
+template <typename T>
+unsigned CompactInterferenceGraph<T>::numEdges() const noexcept {
+  return static_cast<unsigned>(neighborEntries / 2);
+}
+
+template <typename T>
+bool CompactInterferenceGraph<T>::interferes(const T &v, const T &w) const {
+  const Id a = findOrThrow(v);
+  const Id b = findOrThrow(w);
+  return std::binary_search(adjacency[a].begin(), adjacency[a].end(), b);
+}
+
+template <typename T>
+unsigned CompactInterferenceGraph<T>::degree(const T &v) const {
+  return static_cast<unsigned>(adjacency[findOrThrow(v)].size());
+}
+
+template <typename T>
+unsigned CompactInterferenceGraph<T>::getMaxDegree() const {
+  std::size_t maxDegree = 0;
+  for (const auto &list : adjacency) {
+    maxDegree = std::max(maxDegree, list.size());
+  }
+  return static_cast<unsigned>(maxDegree);
+}
+
+template <typename T>
+std::vector<T> CompactInterferenceGraph<T>::getVerticesSortedByDegree() const {
+  std::vector<Id> order(names.size());
+  for (Id id = 0; id < names.size(); id++) {
+    order[id] = id;
+  }
+  std::stable_sort(order.begin(), order.end(), [this](Id a, Id b) {
+    return adjacency[a].size() > adjacency[b].size();
+  });
+
+  std::vector<T> result;
+  result.reserve(order.size());
+  for (const auto id : order) {
+    result.push_back(names[id]);
+  }
+  return result;
+}
+
+template <typename T>
+MemoryUsage CompactInterferenceGraph<T>::memoryUsage() const noexcept {
+  MemoryUsage usage;
+
+  usage.names = names.capacity() * sizeof(T);
+  for (const auto &name : names) {
+    usage.names += heapBytes(name);
+  }
+
+  usage.adjacency = adjacency.capacity() * sizeof(std::vector<Id>);
+  for (const auto &list : adjacency) {
+    usage.adjacency += list.capacity() * sizeof(Id);
+  }
+
+  usage.hashOverhead = slots.capacity() * sizeof(Id);
+  return usage;
+}
+
+template <typename T>
+void CompactInterferenceGraph<T>::shrinkToFit() {
+  names.shrink_to_fit();
+  adjacency.shrink_to_fit();
+  for (auto &list : adjacency) {
+    list.shrink_to_fit();
+  }
+}
+
+#endif
@@ -0,0 +1,232 @@
+/**
+   CompressedGraph.cpp
+
+   See CompressedGraph.hpp for the row encoding.
+
+*/
+
+#include "CompressedGraph.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "CSVReader.hpp"
+#include "FlatHashMap.hpp"
+#include "InputFile.hpp"
+#include "Varint.hpp"
+
+namespace {
+
+void encode(std::vector<std::uint8_t> &out, std::uint32_t n) {
+  while (n >= 0x80) {
+    out.push_back(static_cast<std::uint8_t>((n & 0x7f) | 0x80));
+    n >>= 7;
+  }
+  out.push_back(static_cast<std::uint8_t>(n));
+}
+
+// One sorted, duplicate-free chunk of (vertex << 32 | neighbor) pairs,
+// stored as varint deltas.
+class EdgeRun {
+ public:
+  explicit EdgeRun(const std::vector<std::uint64_t> &sorted) {
+    std::uint64_t previous = 0;
+    for (const auto pair : sorted) {
+      writeVarint(bytes, pair - previous);
+      previous = pair;
+    }
+    bytes.shrink_to_fit();
+  }
+
+  // Moves to the next pair. Returns false at the end of the run.
+  bool next() {
+    std::uint64_t delta = 0;
+    if (!readVarint(bytes, pos, delta)) {
+      return false;
+    }
+    current += delta;
+    return true;
+  }
+
+  std::uint64_t pair() const noexcept { return current; }
+
+ private:
+  std::string bytes;
+  std::size_t pos = 0;
+  std::uint64_t current = 0;
+};
+
+std::uint64_t pairOf(std::uint32_t v, std::uint32_t w) {
+  return static_cast<std::uint64_t>(v) << 32 | w;
+}
+
+};  // namespace
+
+CompressedGraph::CompressedGraph(const IndexedGraph &graph)
+    : edges(graph.numEdges()) {
+  names.reserve(graph.size());
+  offsets.reserve(static_cast<std::size_t>(graph.size()) + 1);
+  // Most entries take one byte; the vector grows if they do not.
+  bytes.reserve(graph.size() + 2 * static_cast<std::size_t>(graph.numEdges()));
+
+  for (Id v = 0; v < graph.size(); v++) {
+    names.push_back(graph.name(v));
+    appendRow(v, graph.neighborsBegin(v), graph.neighborsEnd(v));
+  }
+  offsets.push_back(static_cast<unsigned>(bytes.size()));
+  bytes.shrink_to_fit();
+}
+
+void CompressedGraph::appendRow(Id v, const Id *begin, const Id *end) {
+  offsets.push_back(static_cast<unsigned>(bytes.size()));
+
+  encode(bytes, static_cast<std::uint32_t>(end - begin));
+  if (begin == end) {
+    return;
+  }
+  const Id *it = begin;
+  const std::int64_t delta = static_cast<std::int64_t>(*it) - v;
+  encode(bytes, static_cast<std::uint32_t>(delta < 0 ? -2 * delta - 1
+                                                     : 2 * delta));
+  for (Id previous = *it++; it != end; previous = *it++) {
+    encode(bytes, *it - previous - 1);
+  }
+}
+
+CompressedGraph CompressedGraph::load(const std::string &graph_path,
+                                      std::size_t chunk_entries) {
+  chunk_entries = std::max<std::size_t>(chunk_entries, 2);
+
+  // Names live in a deque so the lookup table can point at them while
+  // more are added.
+  std::deque<Variable> pool;
+  FlatHashMap<std::string_view, Id> ids;
+  const auto idOf = [&pool, &ids](std::string &name) {
+    const auto it = ids.find(name);
+    if (it != ids.end()) {
+      return it->second;
+    }
+    const Id id = static_cast<Id>(pool.size());
+    pool.push_back(std::move(name));
+    ids[pool.back()] = id;
+    return id;
+  };
+
+  std::vector<std::uint64_t> chunk;
+  chunk.reserve(chunk_entries);
+  std::vector<EdgeRun> runs;
+  const auto flush = [&chunk, &runs]() {
+    std::sort(chunk.begin(), chunk.end());
+    chunk.erase(std::unique(chunk.begin(), chunk.end()), chunk.end());
+    runs.emplace_back(chunk);
+    chunk.clear();
+  };
+
+  InputFile file(graph_path);
+  std::string line;
+  while (file.readLine(line)) {
+    auto row = CSVReader::readRow(line);
+    if (row.size() > 2) {
+      throw std::runtime_error(
+          "Graph contains row with more than two vertices: " + graph_path);
+    }
+    if (row.empty()) {
+      continue;
+    }
+    const Id v = idOf(row[0]);
+    if (row.size() == 1) {
+      continue;
+    }
+    const Id w = idOf(row[1]);
+    if (chunk.size() + 2 > chunk_entries) {
+      flush();
+    }
+    chunk.push_back(pairOf(v, w));
+    if (v != w) {
+      chunk.push_back(pairOf(w, v));
+    }
+  }
+  flush();
+  chunk = std::vector<std::uint64_t>();
+
+  ids = FlatHashMap<std::string_view, Id>();
+  CompressedGraph graph;
+  graph.names.assign(std::make_move_iterator(pool.begin()),
+                     std::make_move_iterator(pool.end()));
+  pool.clear();
+  const Id n = static_cast<Id>(graph.names.size());
+  graph.offsets.reserve(static_cast<std::size_t>(n) + 1);
+
+  // Merge the runs in pair order, which is row order, dropping pairs
+  // that appear in more than one run.
+  using Head = std::pair<std::uint64_t, std::size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  for (std::size_t r = 0; r < runs.size(); r++) {
+    if (runs[r].next()) {
+      heads.emplace(runs[r].pair(), r);
+    }
+  }
+
+  std::vector<Id> row;
+  Id v = 0;
+  std::uint64_t entries = 0;
+  bool any = false;
+  std::uint64_t last = 0;
+  while (!heads.empty()) {
+    const auto [pair, r] = heads.top();
+    heads.pop();
+    if (runs[r].next()) {
+      heads.emplace(runs[r].pair(), r);
+    }
+    if (any && pair == last) {
+      continue;
+    }
+    any = true;
+    last = pair;
+
+    const Id from = static_cast<Id>(pair >> 32);
+    while (v < from) {
+      graph.appendRow(v++, row.data(), row.data() + row.size());
+      row.clear();
+    }
+    row.push_back(static_cast<Id>(pair));
+    entries++;
+  }
+  for (; v < n; v++) {
+    graph.appendRow(v, row.data(), row.data() + row.size());
+    row.clear();
+  }
+  graph.offsets.push_back(static_cast<unsigned>(graph.bytes.size()));
+  graph.bytes.shrink_to_fit();
+  graph.edges = static_cast<unsigned>(entries / 2);
+  return graph;
+}
+
+RegisterAssignment CompressedGraph::toAssignment(
+    const std::vector<Register> &colors) const {
+  RegisterAssignment assignment;
+  assignment.reserve(names.size());
+  for (Id v = 0; v < size(); v++) {
+    if (colors[v] != 0) {
+      assignment[names[v]] = colors[v];
+    }
+  }
+  return assignment;
+}
+
+MemoryUsage CompressedGraph::memoryUsage() const noexcept {
+  MemoryUsage usage;
+  usage.names = names.capacity() * sizeof(Variable);
+  for (const auto &name : names) {
+    usage.names += heapBytes(name);
+  }
+  usage.adjacency = offsets.capacity() * sizeof(unsigned) +
+                    bytes.capacity() * sizeof(std::uint8_t);
+  return usage;
+}
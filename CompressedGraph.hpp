@@ -0,0 +1,132 @@
+/**
+   CompressedGraph.hpp
+
+   Read-only, varint-compressed form of an IndexedGraph for graphs too
+   large to keep as 32-bit CSR. Ids, names and coloring vectors are the
+   same as in the IndexedGraph it was built from, unless it was
+   relabeled on the way.
+
+   Every row is one byte stream in `bytes`, starting at offsets[v]:
+
+     degree
+     zigzag(first neighbor - v)
+     (gap - 1) for every further neighbor
+
+   all as LEB128 varints. Neighbor lists are sorted and duplicate free,
+   so the gaps are at least 1. With ids that keep neighbors close together
+   most entries fit one byte, against four in IndexedGraph.
+
+   Building with a VertexOrder other than Original relabels the graph
+   first (see VertexOrder.hpp); ReverseCuthillMcKee usually gives the smallest
+   gaps. Names move with their vertices, so toAssignment() still reports
+   the original variables.
+
+   load() builds the graph straight from a graph file without an
+   InterferenceGraph or IndexedGraph in between. Edges are gathered in
+   fixed-size chunks of (vertex, neighbor) pairs; each full chunk is
+   sorted and kept as a varint-delta run, and the runs are merged into
+   the rows at the end. Besides the result, only one chunk, the
+   compressed runs and the name table are held at a time. Ids follow the
+   order in which names first appear in the file.
+
+   Engines iterate a row with forEachNeighbor(), which decodes on the fly
+   and has the same shape as IndexedGraph::forEachNeighbor(); see
+   GreedyColoring.hpp and GraphClass.hpp.
+
+*/
+
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IndexedGraph.hpp"
+#include "MemoryUsage.hpp"
+#include "VertexOrder.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+class CompressedGraph {
+ public:
+  using Id = IndexedGraph::Id;
+
+  CompressedGraph() = default;
+
+  explicit CompressedGraph(const IndexedGraph &graph);
+
+  CompressedGraph(const IndexedGraph &graph, VertexOrder order)
+      : CompressedGraph(graph.relabeled(vertexOrder(graph, order))) {}
+
+  // Reads a graph file (compressed or not, see InputFile.hpp) with the
+  // same rules as CSVReader::load. `chunk_entries` bounds the edge
+  // buffer; every edge takes two entries of 8 bytes.
+  static CompressedGraph load(const std::string &graph_path,
+                              std::size_t chunk_entries = 1 << 20);
+
+  Id size() const noexcept { return static_cast<Id>(names.size()); }
+
+  unsigned numEdges() const noexcept { return edges; }
+
+  unsigned degree(Id v) const noexcept {
+    const std::uint8_t *p = bytes.data() + offsets[v];
+    return static_cast<unsigned>(decode(p));
+  }
+
+  // Calls visit(neighbor) for every neighbor of v in increasing order.
+  template <typename Visit>
+  void forEachNeighbor(Id v, Visit visit) const {
+    const std::uint8_t *p = bytes.data() + offsets[v];
+    std::uint32_t remaining = decode(p);
+    if (remaining == 0) {
+      return;
+    }
+    const std::uint32_t first = decode(p);
+    Id neighbor = v + static_cast<Id>((first >> 1) ^ (0u - (first & 1)));
+    visit(neighbor);
+    while (--remaining > 0) {
+      neighbor += decode(p) + 1;
+      visit(neighbor);
+    }
+  }
+
+  const Variable &name(Id v) const { return names.at(v); }
+
+  // Same as IndexedGraph::toAssignment.
+  RegisterAssignment toAssignment(const std::vector<Register> &colors) const;
+
+  // `adjacency` counts the encoded rows and the row offsets; there is no
+  // name lookup table, so `hashOverhead` is 0.
+  MemoryUsage memoryUsage() const noexcept;
+
+ private:
+  // Reads one varint and advances p. Single-byte values, the common case,
+  // take the early return.
+  static std::uint32_t decode(const std::uint8_t *&p) noexcept {
+    std::uint32_t n = *p++;
+    if (n < 0x80) {
+      return n;
+    }
+    n &= 0x7f;
+    for (unsigned shift = 7;; shift += 7) {
+      const std::uint32_t byte = *p++;
+      n |= (byte & 0x7f) << shift;
+      if (byte < 0x80) {
+        return n;
+      }
+    }
+  }
+
+  // Appends v's row with its sorted neighbors [begin, end).
+  void appendRow(Id v, const Id *begin, const Id *end);
+
+  std::vector<Variable> names;
+  std::vector<unsigned> offsets;
+  std::vector<std::uint8_t> bytes;
+  unsigned edges = 0;
+};
+
+#endif
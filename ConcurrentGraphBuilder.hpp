@@ -0,0 +1,109 @@
+/**
+   ConcurrentGraphBuilder.hpp
+
+   Lets many threads call addVertex/addEdge at the same time (for example
+   one liveness-analysis thread per basic block) and then produces a
+   normal InterferenceGraph.
+
+   Vertices are split over a fixed number of shards by hash, and every
+   shard has its own mutex and its own adjacency map. addEdge(v, w) locks
+   the shard of v to record w, releases it, then locks the shard of w to
+   record v, so a thread never holds two locks and threads touching
+   different vertices rarely wait on each other.
+
+   Because the shards partition the vertices, build() can splice each
+   shard's hash nodes straight into the graph (unordered_map::merge) with
+   no copying or rehashing of the neighbor sets.
+
+*/
+
+#ifndef CONCURRENT_GRAPH_BUILDER_H
+#define CONCURRENT_GRAPH_BUILDER_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "InterferenceGraph.hpp"
+
+template <typename T>
+class ConcurrentGraphBuilder {
+ public:
+  explicit ConcurrentGraphBuilder(unsigned num_shards = 64);
+
+  // Safe to call from any number of threads at once.
+  void addVertex(const T &vertex);
+
+  // Safe to call from any number of threads at once.
+  void addEdge(const T &v, const T &w);
+
+  // Moves everything added so far into a new graph and leaves the builder
+  // empty. Must not run concurrently with addVertex/addEdge.
+  InterferenceGraph<T> build();
+
+ private:
+  // Padded to a cache line so neighboring shard locks do not false-share.
+  struct alignas(64) Shard {
+    std::mutex lock;
+    std::unordered_map<T, std::unordered_set<T>> adjacency;
+  };
+
+  Shard &shardOf(const T &vertex) {
+    return *shards[std::hash<T>{}(vertex) % shards.size()];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+template <typename T>
+ConcurrentGraphBuilder<T>::ConcurrentGraphBuilder(unsigned num_shards) {
+  shards.resize(num_shards == 0 ? 1 : num_shards);
+  for (auto &shard : shards) {
+    shard = std::make_unique<Shard>();
+  }
+}
+
+template <typename T>
+void ConcurrentGraphBuilder<T>::addVertex(const T &vertex) {
+  Shard &shard = shardOf(vertex);
+  std::lock_guard<std::mutex> guard(shard.lock);
+  shard.adjacency[vertex];
+}
+
+template <typename T>
+void ConcurrentGraphBuilder<T>::addEdge(const T &v, const T &w) {
+  {
+    Shard &shard = shardOf(v);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.adjacency[v].insert(w);
+  }
+  {
+    Shard &shard = shardOf(w);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.adjacency[w].insert(v);
+  }
+}
+
+template <typename T>
+InterferenceGraph<T> ConcurrentGraphBuilder<T>::build() {
+  InterferenceGraph<T> ig;
+
+  std::size_t total = 0;
+  for (const auto &shard : shards) {
+    total += shard->adjacency.size();
+  }
+  ig.adjacencyList.reserve(total);
+
+  for (auto &shard : shards) {
+    std::lock_guard<std::mutex> guard(shard->lock);
+    ig.adjacencyList.merge(shard->adjacency);
+    shard->adjacency.clear();
+  }
+  ig.rebuildDegreeIndex();
+  return ig;
+}
+
+#endif
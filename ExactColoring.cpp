@@ -0,0 +1,251 @@
+/**
+   ExactColoring.cpp
+
+   See ExactColoring.hpp for an overview of the branch and bound.
+
+*/
+
+#include "ExactColoring.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "BitOps.hpp"
+#include "BudgetTracker.hpp"
+#include "GreedyColoring.hpp"
+
+namespace {
+
+using Id = IndexedGraph::Id;
+using Word = std::uint64_t;
+
+const unsigned WORD_BITS = 64;
+
+// Branch and bound state. All per-vertex data is indexed by Id and all
+// register counters are stored flat with `stride` entries per vertex.
+class BranchAndBound {
+ public:
+  BranchAndBound(const IndexedGraph &graph, const SearchBudget &budget)
+      : graph(graph),
+        n(graph.size()),
+        words((n + WORD_BITS - 1) / WORD_BITS),
+        rows(static_cast<std::size_t>(n) * words, 0),
+        uncolored(words, 0),
+        tracker(budget) {
+    for (Id v = 0; v < n; v++) {
+      for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v);
+           ++it) {
+        rows[v * words + *it / WORD_BITS] |= Word(1) << (*it % WORD_BITS);
+      }
+      uncolored[v / WORD_BITS] |= Word(1) << (v % WORD_BITS);
+    }
+  }
+
+  proj6::ExactResult run() {
+    proj6::ExactResult result;
+    if (n == 0) {
+      result.optimal = true;
+      return result;
+    }
+
+    const auto clique = greedyClique();
+    best = dsaturHeuristic();
+    bestRegisters = *std::max_element(best.begin(), best.end());
+
+    if (static_cast<Register>(clique.size()) < bestRegisters) {
+      lowerBound = static_cast<Register>(clique.size());
+      stride = static_cast<std::size_t>(bestRegisters) + 1;
+      colors.assign(n, 0);
+      neighborsWith.assign(n * stride, 0);
+      saturation.assign(n, 0);
+
+      // The clique needs distinct registers in any coloring, so fixing
+      // them up front removes that much symmetry from the search.
+      Register next = 1;
+      for (const auto v : clique) {
+        assign(v, next++);
+      }
+      search(next - 1, static_cast<Id>(clique.size()));
+    }
+
+    result.colors = best;
+    result.numRegisters = bestRegisters;
+    result.optimal = !aborted || bestRegisters == lowerBound;
+    return result;
+  }
+
+ private:
+  const Word *row(Id v) const { return rows.data() + v * words; }
+
+  // Greedily grow a clique from every vertex, always adding the candidate
+  // adjacent to the most other candidates, and keep the largest one.
+  std::vector<Id> greedyClique() const {
+    std::vector<Id> largest;
+    std::vector<Word> candidates(words);
+    for (Id seed = 0; seed < n; seed++) {
+      if (graph.degree(seed) + 1 <= largest.size()) {
+        continue;
+      }
+      std::vector<Id> clique = {seed};
+      std::copy(row(seed), row(seed) + words, candidates.begin());
+      while (true) {
+        Id pick = n;
+        unsigned pickScore = 0;
+        for (unsigned w = 0; w < words; w++) {
+          for (Word bits = candidates[w]; bits != 0; bits &= bits - 1) {
+            const Id v = w * WORD_BITS + lowestBit(bits);
+            unsigned score = 0;
+            for (unsigned x = 0; x < words; x++) {
+              score += popcount(row(v)[x] & candidates[x]);
+            }
+            if (pick == n || score > pickScore) {
+              pick = v;
+              pickScore = score;
+            }
+          }
+        }
+        if (pick == n) {
+          break;
+        }
+        clique.push_back(pick);
+        for (unsigned w = 0; w < words; w++) {
+          candidates[w] &= row(pick)[w];
+        }
+      }
+      if (clique.size() > largest.size()) {
+        largest = std::move(clique);
+      }
+    }
+    return largest;
+  }
+
+  std::vector<Register> dsaturHeuristic() {
+    const std::size_t width = static_cast<std::size_t>(n) + 2;
+    colors.assign(n, 0);
+    stride = width;
+    neighborsWith.assign(n * width, 0);
+    saturation.assign(n, 0);
+    for (Id colored = 0; colored < n; colored++) {
+      const Id v = pickVertex();
+      Register c = 1;
+      while (neighborsWith[v * stride + c] != 0) {
+        c++;
+      }
+      assign(v, c);
+    }
+    auto result = colors;
+    std::fill(uncolored.begin(), uncolored.end(), 0);
+    for (Id v = 0; v < n; v++) {
+      uncolored[v / WORD_BITS] |= Word(1) << (v % WORD_BITS);
+    }
+    return result;
+  }
+
+  // Uncolored vertex with the highest saturation, ties broken by degree.
+  Id pickVertex() const {
+    Id pick = n;
+    for (unsigned w = 0; w < words; w++) {
+      for (Word bits = uncolored[w]; bits != 0; bits &= bits - 1) {
+        const Id v = w * WORD_BITS + lowestBit(bits);
+        if (pick == n || saturation[v] > saturation[pick] ||
+            (saturation[v] == saturation[pick] &&
+             graph.degree(v) > graph.degree(pick))) {
+          pick = v;
+        }
+      }
+    }
+    return pick;
+  }
+
+  // Give v register c and update the saturation of its uncolored
+  // neighbors, found by intersecting v's row with the uncolored set.
+  void assign(Id v, Register c) {
+    colors[v] = c;
+    uncolored[v / WORD_BITS] &= ~(Word(1) << (v % WORD_BITS));
+    for (unsigned w = 0; w < words; w++) {
+      for (Word bits = row(v)[w] & uncolored[w]; bits != 0; bits &= bits - 1) {
+        const Id u = w * WORD_BITS + lowestBit(bits);
+        if (neighborsWith[u * stride + c]++ == 0) {
+          saturation[u]++;
+        }
+      }
+    }
+  }
+
+  void unassign(Id v) {
+    const Register c = colors[v];
+    for (unsigned w = 0; w < words; w++) {
+      for (Word bits = row(v)[w] & uncolored[w]; bits != 0; bits &= bits - 1) {
+        const Id u = w * WORD_BITS + lowestBit(bits);
+        if (--neighborsWith[u * stride + c] == 0) {
+          saturation[u]--;
+        }
+      }
+    }
+    uncolored[v / WORD_BITS] |= Word(1) << (v % WORD_BITS);
+    colors[v] = 0;
+  }
+
+  void search(Register used, Id colored) {
+    if (tracker.exhausted()) {
+      aborted = true;
+      return;
+    }
+    if (colored == n) {
+      best = colors;
+      bestRegisters = used;
+      return;
+    }
+
+    const Id v = pickVertex();
+    // Only registers below the best known count are worth trying, and a
+    // brand new register only needs to be tried once (they are symmetric).
+    const Register limit = std::min(used + 1, bestRegisters - 1);
+    for (Register c = 1; c <= limit; c++) {
+      if (neighborsWith[v * stride + c] != 0) {
+        continue;
+      }
+      assign(v, c);
+      search(std::max(used, c), colored + 1);
+      unassign(v);
+      if (aborted || bestRegisters == lowerBound) {
+        return;
+      }
+    }
+  }
+
+  const IndexedGraph &graph;
+  const Id n;
+  const unsigned words;
+  std::vector<Word> rows;
+  std::vector<Word> uncolored;
+  BudgetTracker tracker;
+
+  std::size_t stride = 0;
+  std::vector<Register> colors;
+  std::vector<unsigned> neighborsWith;
+  std::vector<unsigned> saturation;
+
+  std::vector<Register> best;
+  Register bestRegisters = 0;
+  Register lowerBound = 0;
+  bool aborted = false;
+};
+
+};  // namespace
+
+proj6::ExactResult proj6::exactColoring(const IndexedGraph &graph,
+                                        const SearchBudget &budget) {
+  if (graph.size() > MAX_EXACT_VERTICES) {
+    ExactResult result;
+    result.colors = largestFirstColoring(graph);
+    for (const auto c : result.colors) {
+      result.numRegisters = std::max(result.numRegisters, c);
+    }
+    return result;
+  }
+
+  BranchAndBound search(graph, budget);
+  return search.run();
+}
@@ -0,0 +1,47 @@
+/**
+   ExactColoring.hpp
+
+   Exact minimum coloring for small graphs. The graph is copied into
+   bit-parallel adjacency rows (one bit per vertex, 64 vertices per word),
+   a greedy clique gives a lower bound and a DSatur coloring gives the
+   first upper bound. A DSatur-style branch and bound (always branch on
+   the uncolored vertex whose neighbors use the most distinct registers)
+   then closes the gap, pruning any branch that would need as many
+   registers as the best coloring already found.
+
+   The search stops after SearchBudget::iterations nodes or
+   SearchBudget::time, whichever comes first, and then returns the best
+   coloring it has. Graphs with more than MAX_EXACT_VERTICES vertices are
+   not searched at all; they get the greedy heuristic coloring.
+
+*/
+
+#ifndef EXACT_COLORING_H
+#define EXACT_COLORING_H
+
+#include <vector>
+
+#include "IndexedGraph.hpp"
+#include "proj6.hpp"
+
+namespace proj6 {
+
+const IndexedGraph::Id MAX_EXACT_VERTICES = 512;
+
+struct ExactResult {
+  // A valid coloring of every vertex, registers starting at 1.
+  std::vector<Register> colors;
+
+  // Number of registers used by `colors`.
+  Register numRegisters = 0;
+
+  // True if `colors` is known to use the fewest possible registers.
+  bool optimal = false;
+};
+
+ExactResult exactColoring(const IndexedGraph &graph,
+                          const SearchBudget &budget);
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,402 @@
+/**
+   FlatHashMap.hpp
+
+   Open-addressing hash map and set with the entries stored inline in one
+   array, for the hot lookups that std::unordered_map answers with a
+   pointer chase per node (vertex name -> id, small per-vertex sets).
+
+   The layout follows the "Swiss table" design. Next to the slot array is
+   one control byte per slot: EMPTY, DELETED, or the low 7 bits of the
+   key's (mixed) hash for a full slot. A lookup loads a group of GROUP_WIDTH
+   control bytes and compares all of them against the 7 hash bits at once
+   (one SSE2 compare; a plain loop elsewhere). Only slots whose bits match
+   have their keys compared. Groups are probed quadratically and the
+   table grows at 7/8 full. The first group of control bytes is mirrored
+   after the last, so a group load never wraps.
+
+   Erasing leaves a DELETED marker that insertions reuse. Iterators and
+   references are invalidated by any insertion that grows the table.
+   Keys and values must be default constructible; free slots hold
+   default-constructed entries.
+
+*/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "BitOps.hpp"
+
+template <typename K, typename V, typename Hash = std::hash<K>>
+class FlatHashMap {
+ public:
+  using value_type = std::pair<K, V>;
+
+  template <bool Const>
+  class Iterator {
+   public:
+    using Table = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+    using Reference = std::conditional_t<Const, const value_type &,
+                                         value_type &>;
+    using Pointer = std::conditional_t<Const, const value_type *,
+                                       value_type *>;
+
+    Iterator(Table *table, std::size_t index) : table(table), index(index) {
+      skipFree();
+    }
+
+    Reference operator*() const { return table->slots[index]; }
+
+    Pointer operator->() const { return &table->slots[index]; }
+
+    Iterator &operator++() {
+      index++;
+      skipFree();
+      return *this;
+    }
+
+    bool operator==(const Iterator &other) const {
+      return index == other.index;
+    }
+
+    bool operator!=(const Iterator &other) const {
+      return index != other.index;
+    }
+
+   private:
+    void skipFree() {
+      while (index < table->slots.size() && table->control[index] < 0) {
+        index++;
+      }
+    }
+
+    Table *table;
+    std::size_t index;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() = default;
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, slots.size()}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, slots.size()}; }
+
+  std::size_t size() const noexcept { return entries; }
+
+  bool empty() const noexcept { return entries == 0; }
+
+  // Removes every entry but keeps the table's capacity.
+  void clear() {
+    if (entries == 0 && growthLeft == maxLoad(slots.size())) {
+      return;
+    }
+    for (std::size_t i = 0; i < slots.size(); i++) {
+      if (control[i] >= 0) {
+        slots[i] = value_type();
+      }
+    }
+    std::fill(control.begin(), control.end(), EMPTY);
+    entries = 0;
+    growthLeft = maxLoad(slots.size());
+  }
+
+  // Makes room for `n` entries without growing.
+  void reserve(std::size_t n) {
+    std::size_t capacity = GROUP_WIDTH;
+    while (maxLoad(capacity) < n) {
+      capacity *= 2;
+    }
+    if (capacity > slots.size()) {
+      rehash(capacity);
+    }
+  }
+
+  iterator find(const K &key) { return {this, findIndex(key)}; }
+
+  const_iterator find(const K &key) const { return {this, findIndex(key)}; }
+
+  std::size_t count(const K &key) const {
+    return findIndex(key) != slots.size() ? 1 : 0;
+  }
+
+  bool contains(const K &key) const { return findIndex(key) != slots.size(); }
+
+  V &at(const K &key) {
+    const std::size_t i = findIndex(key);
+    if (i == slots.size()) {
+      throw std::out_of_range("FlatHashMap::at");
+    }
+    return slots[i].second;
+  }
+
+  const V &at(const K &key) const {
+    const std::size_t i = findIndex(key);
+    if (i == slots.size()) {
+      throw std::out_of_range("FlatHashMap::at");
+    }
+    return slots[i].second;
+  }
+
+  V &operator[](const K &key) { return try_emplace(key).first->second; }
+
+  // Inserts (key, V(args...)) if key is absent. Returns the entry and
+  // whether it was inserted, like std::unordered_map::try_emplace.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K &key, Args &&...args) {
+    const std::size_t hash = hashOf(key);
+    const std::size_t found = findIndex(key, hash);
+    if (found != slots.size()) {
+      return {iterator(this, found), false};
+    }
+
+    if (slots.empty()) {
+      rehash(GROUP_WIDTH);
+    }
+    std::size_t i = findFree(hash);
+    if (growthLeft == 0 && control[i] == EMPTY) {
+      // Mostly DELETED markers: rebuild at the same size to drop them.
+      const bool crowded = 2 * entries >= maxLoad(slots.size());
+      rehash(crowded ? 2 * slots.size() : slots.size());
+      i = findFree(hash);
+    }
+    if (control[i] == EMPTY) {
+      growthLeft--;
+    }
+    setControl(i, fingerprint(hash));
+    slots[i] = value_type(key, V(std::forward<Args>(args)...));
+    entries++;
+    return {iterator(this, i), true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type &entry) {
+    return try_emplace(entry.first, entry.second);
+  }
+
+  std::size_t erase(const K &key) {
+    const std::size_t i = findIndex(key);
+    if (i == slots.size()) {
+      return 0;
+    }
+    slots[i] = value_type();
+    setControl(i, DELETED);
+    entries--;
+    return 1;
+  }
+
+  // Bytes owned by the table (slot and control arrays), not counting
+  // heap memory owned by the keys and values themselves.
+  std::size_t tableBytes() const noexcept {
+    return slots.capacity() * sizeof(value_type) + control.capacity();
+  }
+
+  // Work a lookup of `key` does: control groups loaded and keys compared.
+  // A well-spread table needs about one of each; keys that share home
+  // groups or fingerprints need many.
+  struct ProbeCount {
+    std::size_t groups = 0;
+    std::size_t compares = 0;
+  };
+
+  ProbeCount probeCount(const K &key) const {
+    ProbeCount count;
+    findIndex(key, hashOf(key), &count);
+    return count;
+  }
+
+ private:
+  static constexpr std::size_t GROUP_WIDTH = 16;
+  static constexpr std::int8_t EMPTY = -128;
+  static constexpr std::int8_t DELETED = -2;
+
+  // Bit i is set if control byte i of the group at `pos` equals `byte`.
+  std::uint32_t matchGroup(std::size_t pos, std::int8_t byte) const {
+#if defined(__SSE2__)
+    const __m128i group = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(control.data() + pos));
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte))));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < GROUP_WIDTH; i++) {
+      if (control[pos + i] == byte) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+#endif
+  }
+
+  // Bit i is set if slot pos + i is EMPTY or DELETED (sign bit set).
+  std::uint32_t matchFree(std::size_t pos) const {
+#if defined(__SSE2__)
+    const __m128i group = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(control.data() + pos));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(group));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < GROUP_WIDTH; i++) {
+      if (control[pos + i] < 0) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+#endif
+  }
+
+  // std::hash of an integer is the identity on common libraries, which
+  // would put every small key in group 0 and give them all equal
+  // fingerprints. The murmur3 finalizer spreads every input bit over the
+  // whole word before it is split into fingerprint and home.
+  static std::size_t hashOf(const K &key) {
+    std::uint64_t h = static_cast<std::uint64_t>(Hash{}(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+
+  static std::int8_t fingerprint(std::size_t hash) {
+    return static_cast<std::int8_t>(hash & 0x7f);
+  }
+
+  // The fingerprint uses the low bits, so probing starts from the rest.
+  static std::size_t home(std::size_t hash) { return hash >> 7; }
+
+  static std::size_t maxLoad(std::size_t capacity) {
+    return capacity - capacity / 8;
+  }
+
+  std::size_t findIndex(const K &key) const {
+    return findIndex(key, hashOf(key));
+  }
+
+  // Index of the slot holding key, or slots.size() if there is none.
+  // Adds the work done to `count` if it is not null.
+  std::size_t findIndex(const K &key, std::size_t hash,
+                        ProbeCount *count = nullptr) const {
+    if (slots.empty()) {
+      return 0;
+    }
+    const std::size_t mask = slots.size() - 1;
+    const std::int8_t byte = fingerprint(hash);
+    std::size_t pos = home(hash) & mask;
+    for (std::size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+      if (count != nullptr) {
+        count->groups++;
+      }
+      for (std::uint32_t hits = matchGroup(pos, byte); hits != 0;
+           hits &= hits - 1) {
+        const std::size_t i = (pos + lowestBit(hits)) & mask;
+        if (count != nullptr) {
+          count->compares++;
+        }
+        if (slots[i].first == key) {
+          return i;
+        }
+      }
+      if (matchGroup(pos, EMPTY) != 0) {
+        return slots.size();
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  // First EMPTY or DELETED slot on the probe sequence of `hash`.
+  std::size_t findFree(std::size_t hash) const {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t pos = home(hash) & mask;
+    for (std::size_t step = GROUP_WIDTH;; step += GROUP_WIDTH) {
+      const std::uint32_t free = matchFree(pos);
+      if (free != 0) {
+        return (pos + lowestBit(free)) & mask;
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  void setControl(std::size_t i, std::int8_t byte) {
+    control[i] = byte;
+    if (i < GROUP_WIDTH) {
+      control[slots.size() + i] = byte;
+    }
+  }
+
+  void rehash(std::size_t capacity) {
+    std::vector<value_type> oldSlots(capacity);
+    std::vector<std::int8_t> oldControl(capacity + GROUP_WIDTH, EMPTY);
+    oldSlots.swap(slots);
+    oldControl.swap(control);
+    growthLeft = maxLoad(capacity) - entries;
+
+    for (std::size_t i = 0; i < oldSlots.size(); i++) {
+      if (oldControl[i] >= 0) {
+        const std::size_t hash = hashOf(oldSlots[i].first);
+        const std::size_t j = findFree(hash);
+        setControl(j, fingerprint(hash));
+        slots[j] = std::move(oldSlots[i]);
+      }
+    }
+  }
+
+  std::vector<value_type> slots;
+  // slots.size() + GROUP_WIDTH bytes; the tail mirrors the first group.
+  std::vector<std::int8_t> control;
+  std::size_t entries = 0;
+  std::size_t growthLeft = 0;
+};
+
+// Set version of FlatHashMap, with the same layout and probing.
+template <typename K, typename Hash = std::hash<K>>
+class FlatHashSet {
+ public:
+  std::size_t size() const noexcept { return map.size(); }
+
+  bool empty() const noexcept { return map.empty(); }
+
+  void clear() { map.clear(); }
+
+  void reserve(std::size_t n) { map.reserve(n); }
+
+  // True if the key was not in the set yet.
+  bool insert(const K &key) { return map.try_emplace(key).second; }
+
+  std::size_t count(const K &key) const { return map.count(key); }
+
+  bool contains(const K &key) const { return map.contains(key); }
+
+  std::size_t erase(const K &key) { return map.erase(key); }
+
+  // See FlatHashMap::probeCount.
+  auto probeCount(const K &key) const { return map.probeCount(key); }
+
+  template <typename Visit>
+  void forEach(Visit visit) const {
+    for (const auto &entry : map) {
+      visit(entry.first);
+    }
+  }
+
+ private:
+  struct Nothing {};
+
+  FlatHashMap<K, Nothing, Hash> map;
+};
+
+#endif
@@ -0,0 +1,195 @@
+/**
+   GraphClass.cpp
+
+   See GraphClass.hpp. Everything is written against forEachNeighbor(),
+   size() and degree(), so the same code runs on IndexedGraph and
+   CompressedGraph.
+
+*/
+
+#include "GraphClass.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "BitOps.hpp"
+#include "GreedyColoring.hpp"
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+// Degree without the self-loop, if there is one.
+template <typename Graph>
+unsigned properDegree(const Graph &graph, Id v) {
+  unsigned loops = 0;
+  graph.forEachNeighbor(v, [&loops, v](Id w) { loops += w == v; });
+  return graph.degree(v) - loops;
+}
+
+struct Shape {
+  unsigned maxDegree = 0;
+  // Edges between two different vertices.
+  std::uint64_t edges = 0;
+};
+
+template <typename Graph>
+Shape shapeOf(const Graph &graph) {
+  Shape shape;
+  std::uint64_t entries = 0;
+  for (Id v = 0; v < graph.size(); v++) {
+    const unsigned degree = properDegree(graph, v);
+    shape.maxDegree = std::max(shape.maxDegree, degree);
+    entries += degree;
+  }
+  shape.edges = entries / 2;
+  return shape;
+}
+
+// Breadth-first 2-coloring into `colors` (registers 1 and 2). Returns
+// false as soon as a vertex has an edge joining two vertices of the same
+// color. `components` counts the BFS trees started.
+template <typename Graph>
+bool twoColor(const Graph &graph, std::vector<Register> &colors,
+              std::uint64_t &components) {
+  colors.assign(graph.size(), 0);
+  components = 0;
+  std::vector<Id> queue;
+  queue.reserve(graph.size());
+  for (Id root = 0; root < graph.size(); root++) {
+    if (colors[root] != 0) {
+      continue;
+    }
+    components++;
+    colors[root] = 1;
+    queue.clear();
+    queue.push_back(root);
+    for (std::size_t head = 0; head < queue.size(); head++) {
+      const Id v = queue[head];
+      bool odd = false;
+      graph.forEachNeighbor(v, [&](Id w) {
+        if (w == v) {
+          return;
+        }
+        if (colors[w] == 0) {
+          colors[w] = 3 - colors[v];
+          queue.push_back(w);
+        } else if (colors[w] == colors[v]) {
+          odd = true;
+        }
+      });
+      if (odd) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool isComplete(std::uint64_t n, const Shape &shape) {
+  return n > 1 && shape.edges == n * (n - 1) / 2;
+}
+
+// Largest degree first, like Welsh-Powell, but the degrees are counting
+// sorted and each vertex's taken registers fit one RegisterMask, so it
+// is linear in the size of the graph.
+template <typename Graph>
+std::vector<Register> colorSmallDegree(const Graph &graph,
+                                       unsigned maxDegree) {
+  std::vector<Id> start(maxDegree + 2, 0);
+  for (Id v = 0; v < graph.size(); v++) {
+    start[maxDegree - properDegree(graph, v) + 1]++;
+  }
+  for (unsigned d = 1; d < start.size(); d++) {
+    start[d] += start[d - 1];
+  }
+  std::vector<Id> order(graph.size());
+  for (Id v = 0; v < graph.size(); v++) {
+    order[start[maxDegree - properDegree(graph, v)]++] = v;
+  }
+
+  std::vector<Register> colors(graph.size(), 0);
+  for (const auto v : order) {
+    RegisterMask taken = 0;
+    graph.forEachNeighbor(v, [&colors, &taken](Id w) {
+      if (colors[w] != 0) {
+        taken |= RegisterMask(1) << (colors[w] - 1);
+      }
+    });
+    colors[v] = static_cast<Register>(lowestBit(~taken)) + 1;
+  }
+  return colors;
+}
+
+template <typename Graph>
+GraphClass classify(const Graph &graph) {
+  const Shape shape = shapeOf(graph);
+  if (shape.edges == 0) {
+    return GraphClass::Edgeless;
+  }
+  if (isComplete(graph.size(), shape)) {
+    return GraphClass::Complete;
+  }
+
+  std::vector<Register> colors;
+  std::uint64_t components = 0;
+  if (twoColor(graph, colors, components)) {
+    return shape.edges + components == graph.size() ? GraphClass::Forest
+                                                    : GraphClass::Bipartite;
+  }
+  return shape.maxDegree < MAX_CONSTRAINED_REGISTERS ? GraphClass::SmallDegree
+                                                      : GraphClass::General;
+}
+
+template <typename Graph>
+ClassColoring color(const Graph &graph) {
+  ClassColoring result;
+  const Shape shape = shapeOf(graph);
+
+  if (shape.edges == 0) {
+    result.graphClass = GraphClass::Edgeless;
+    result.colors.assign(graph.size(), 1);
+  } else if (isComplete(graph.size(), shape)) {
+    result.graphClass = GraphClass::Complete;
+    result.colors.resize(graph.size());
+    for (Id v = 0; v < graph.size(); v++) {
+      result.colors[v] = static_cast<Register>(v) + 1;
+    }
+  } else {
+    std::uint64_t components = 0;
+    if (twoColor(graph, result.colors, components)) {
+      result.graphClass = shape.edges + components == graph.size()
+                              ? GraphClass::Forest
+                              : GraphClass::Bipartite;
+    } else if (shape.maxDegree < MAX_CONSTRAINED_REGISTERS) {
+      result.graphClass = GraphClass::SmallDegree;
+      result.colors = colorSmallDegree(graph, shape.maxDegree);
+    } else {
+      result.graphClass = GraphClass::General;
+      result.colors = largestFirstColoring(graph);
+    }
+  }
+
+  for (const auto c : result.colors) {
+    result.numRegisters = std::max(result.numRegisters, c);
+  }
+  return result;
+}
+
+};  // namespace
+
+GraphClass proj6::classifyGraph(const IndexedGraph &graph) {
+  return classify(graph);
+}
+
+GraphClass proj6::classifyGraph(const CompressedGraph &graph) {
+  return classify(graph);
+}
+
+ClassColoring proj6::colorByClass(const IndexedGraph &graph) {
+  return color(graph);
+}
+
+ClassColoring proj6::colorByClass(const CompressedGraph &graph) {
+  return color(graph);
+}
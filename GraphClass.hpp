@@ -0,0 +1,70 @@
+/**
+   GraphClass.hpp
+
+   Cheap structural classification of an id graph (IndexedGraph, or the
+   varint-compressed CompressedGraph for graphs too large for CSR), and
+   colorers for the classes where the best coloring is known without
+   searching. Many per-function interference graphs are trees, bipartite
+   or cliques, and for those the general greedy engine does more work
+   than needed, and can use more registers than needed too.
+
+   Classification is one pass over the neighbor lists plus, if needed, one
+   breadth-first 2-coloring, so O(V + E). Self-loops are ignored, just
+   like in the greedy engines.
+
+     Edgeless     no edges: one register.
+     Complete     every pair interferes: one register per vertex.
+     Forest       no cycles: two registers.
+     Bipartite    no odd cycles: two registers.
+     SmallDegree  max degree below MAX_CONSTRAINED_REGISTERS: largest
+                  degree first greedy with a counting sort and one
+                  RegisterMask per vertex instead of a sort and a scan.
+     General      anything else: largestFirstColoring (GreedyColoring.hpp).
+
+   The first four colorings are optimal. The last two use at most
+   d(G) + 1 registers.
+
+*/
+
+#ifndef GRAPH_CLASS_H
+#define GRAPH_CLASS_H
+
+#include <vector>
+
+#include "CompressedGraph.hpp"
+#include "IndexedGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+// In the order they are tested: a graph gets the first class it fits.
+enum class GraphClass {
+  Edgeless,
+  Complete,
+  Forest,
+  Bipartite,
+  SmallDegree,
+  General,
+};
+
+struct ClassColoring {
+  GraphClass graphClass = GraphClass::Edgeless;
+  // Indexed by id; every vertex gets a register starting at 1.
+  std::vector<Register> colors;
+  Register numRegisters = 0;
+};
+
+namespace proj6 {
+
+GraphClass classifyGraph(const IndexedGraph &graph);
+
+GraphClass classifyGraph(const CompressedGraph &graph);
+
+// Classifies the graph and colors it with the matching colorer.
+ClassColoring colorByClass(const IndexedGraph &graph);
+
+ClassColoring colorByClass(const CompressedGraph &graph);
+
+};  // namespace proj6
+
+#endif
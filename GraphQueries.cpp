@@ -0,0 +1,169 @@
+/**
+   GraphQueries.cpp
+
+   See GraphQueries.hpp. Cliques are counted once each by only extending
+   a clique with neighbors of higher id than its last vertex.
+
+*/
+
+#include "GraphQueries.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+// Calls emit(id) for every id in both sorted, duplicate-free ranges, in
+// increasing order.
+template <typename Emit>
+void intersect(const Id *a, const Id *aEnd, const Id *b, const Id *bEnd,
+               Emit emit) {
+#if defined(__SSE2__)
+  // Compare a block of four from each side in all four rotations. The
+  // block with the smaller last id cannot match anything further on in
+  // the other range, so it is the one to advance (both on a tie).
+  while (aEnd - a >= 4 && bEnd - b >= 4) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    const __m128i rotated1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    const __m128i rotated2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m128i rotated3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+    const __m128i equal =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                                  _mm_cmpeq_epi32(va, rotated1)),
+                     _mm_or_si128(_mm_cmpeq_epi32(va, rotated2),
+                                  _mm_cmpeq_epi32(va, rotated3)));
+    const int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+    for (int k = 0; k < 4; k++) {
+      if (mask & (1 << k)) {
+        emit(a[k]);
+      }
+    }
+
+    const Id aLast = a[3];
+    const Id bLast = b[3];
+    if (aLast <= bLast) {
+      a += 4;
+    }
+    if (bLast <= aLast) {
+      b += 4;
+    }
+  }
+#endif
+  while (a != aEnd && b != bEnd) {
+    if (*a < *b) {
+      ++a;
+    } else if (*b < *a) {
+      ++b;
+    } else {
+      emit(*a);
+      ++a;
+      ++b;
+    }
+  }
+}
+
+// Neighbors of v with a higher id than v.
+const Id *forwardBegin(const IndexedGraph &graph, Id v) {
+  return std::upper_bound(graph.neighborsBegin(v), graph.neighborsEnd(v), v);
+}
+
+// Extends a clique whose common higher-id neighbors are `candidates` by
+// `remaining` more vertices.
+std::uint64_t extendCliques(const IndexedGraph &graph,
+                            const std::vector<Id> &candidates,
+                            unsigned remaining) {
+  if (remaining == 1) {
+    return candidates.size();
+  }
+  std::uint64_t count = 0;
+  std::vector<Id> next;
+  for (const auto u : candidates) {
+    next.clear();
+    intersect(candidates.data(), candidates.data() + candidates.size(),
+              forwardBegin(graph, u), graph.neighborsEnd(u),
+              [&next](Id w) { next.push_back(w); });
+    if (next.size() >= remaining - 1) {
+      count += extendCliques(graph, next, remaining - 1);
+    }
+  }
+  return count;
+}
+
+};  // namespace
+
+std::vector<bool> proj6::interferesMany(
+    const IndexedGraph &graph, IndexedGraph::Id v,
+    const std::vector<IndexedGraph::Id> &candidates) {
+  // Visit the candidates in id order so the row is searched left to
+  // right, each search starting where the last one stopped.
+  std::vector<std::size_t> order(candidates.size());
+  for (std::size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&candidates](auto a, auto b) {
+    return candidates[a] < candidates[b];
+  });
+
+  std::vector<bool> result(candidates.size(), false);
+  const Id *it = graph.neighborsBegin(v);
+  const Id *end = graph.neighborsEnd(v);
+  for (const auto i : order) {
+    it = std::lower_bound(it, end, candidates[i]);
+    result[i] = it != end && *it == candidates[i];
+  }
+  return result;
+}
+
+std::vector<IndexedGraph::Id> proj6::commonNeighbors(
+    const IndexedGraph &graph, IndexedGraph::Id v, IndexedGraph::Id w) {
+  std::vector<Id> result;
+  intersect(graph.neighborsBegin(v), graph.neighborsEnd(v),
+            graph.neighborsBegin(w), graph.neighborsEnd(w),
+            [&result](Id u) { result.push_back(u); });
+  return result;
+}
+
+unsigned proj6::countCommonNeighbors(const IndexedGraph &graph,
+                                     IndexedGraph::Id v, IndexedGraph::Id w) {
+  unsigned count = 0;
+  intersect(graph.neighborsBegin(v), graph.neighborsEnd(v),
+            graph.neighborsBegin(w), graph.neighborsEnd(w),
+            [&count](Id) { count++; });
+  return count;
+}
+
+std::uint64_t proj6::countTriangles(const IndexedGraph &graph) {
+  std::uint64_t count = 0;
+  for (Id v = 0; v < graph.size(); v++) {
+    const Id *vForward = forwardBegin(graph, v);
+    for (const Id *u = vForward; u != graph.neighborsEnd(v); ++u) {
+      intersect(vForward, graph.neighborsEnd(v), forwardBegin(graph, *u),
+                graph.neighborsEnd(*u), [&count](Id) { count++; });
+    }
+  }
+  return count;
+}
+
+std::uint64_t proj6::countCliques(const IndexedGraph &graph, unsigned size) {
+  if (size == 0) {
+    return 0;
+  }
+  if (size == 1) {
+    return graph.size();
+  }
+  std::uint64_t count = 0;
+  std::vector<Id> candidates;
+  for (Id v = 0; v < graph.size(); v++) {
+    candidates.assign(forwardBegin(graph, v), graph.neighborsEnd(v));
+    if (candidates.size() >= size - 1) {
+      count += extendCliques(graph, candidates, size - 1);
+    }
+  }
+  return count;
+}
@@ -0,0 +1,49 @@
+/**
+   GraphQueries.hpp
+
+   Batched neighborhood queries over an IndexedGraph, for the coalescing
+   and spill heuristics that would otherwise make many interferes() calls
+   (two string hash lookups each).
+
+   All queries work on the sorted neighbor rows. Intersections use an
+   SSE2 kernel that compares four ids of each row against each other per
+   step, falling back to a plain merge for the tails and on targets
+   without SSE2.
+
+*/
+
+#ifndef GRAPH_QUERIES_H
+#define GRAPH_QUERIES_H
+
+#include <cstdint>
+#include <vector>
+
+#include "IndexedGraph.hpp"
+
+namespace proj6 {
+
+// result[i] is true if v interferes with candidates[i]. Candidates may
+// repeat and come in any order.
+std::vector<bool> interferesMany(
+    const IndexedGraph &graph, IndexedGraph::Id v,
+    const std::vector<IndexedGraph::Id> &candidates);
+
+// Sorted ids of the vertices adjacent to both v and w.
+std::vector<IndexedGraph::Id> commonNeighbors(const IndexedGraph &graph,
+                                              IndexedGraph::Id v,
+                                              IndexedGraph::Id w);
+
+unsigned countCommonNeighbors(const IndexedGraph &graph, IndexedGraph::Id v,
+                              IndexedGraph::Id w);
+
+// Number of triangles (3-cliques) in the graph.
+std::uint64_t countTriangles(const IndexedGraph &graph);
+
+// Number of cliques with exactly `size` vertices. size 1 counts vertices
+// and size 2 counts edges. Exponential in `size`, so meant for small
+// sizes. Self-loops are ignored.
+std::uint64_t countCliques(const IndexedGraph &graph, unsigned size);
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,48 @@
+/**
+   GreedyColoring.hpp
+
+   Largest-degree-first greedy coloring over integer ids. Templated on the
+   graph so it runs on any read-only id graph that provides size(),
+   degree(v) and forEachNeighbor(v, visit): IndexedGraph or the
+   varint-compressed CompressedGraph.
+
+   Registers start at 1 and at most (max degree + 1) are used.
+
+*/
+
+#ifndef GREEDY_COLORING_H
+#define GREEDY_COLORING_H
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "proj6.hpp"
+
+template <typename Graph>
+std::vector<proj6::Register> largestFirstColoring(const Graph &graph) {
+  using Id = std::uint32_t;
+
+  std::vector<Id> order(graph.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&graph](Id a, Id b) {
+    return graph.degree(a) > graph.degree(b);
+  });
+
+  std::vector<proj6::Register> colors(graph.size(), 0);
+  // lastSeen[c] == v + 1 means register c is used by a neighbor of v.
+  std::vector<Id> lastSeen(static_cast<std::size_t>(graph.size()) + 2, 0);
+  for (const auto v : order) {
+    graph.forEachNeighbor(
+        v, [&lastSeen, &colors, v](Id w) { lastSeen[colors[w]] = v + 1; });
+    proj6::Register c = 1;
+    while (lastSeen[c] == v + 1) {
+      c++;
+    }
+    colors[v] = c;
+  }
+  return colors;
+}
+
+#endif
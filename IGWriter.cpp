@@ -41,7 +41,10 @@ std::string lookupColor(const Variable &var,
   return "darkgrey";
 }
 
-void writeEdges(const InterferenceGraph<Variable> &ig, std::ofstream &stream) {
+// The helpers below take any graph type with vertices() and neighbors():
+// InterferenceGraph<Variable> or GraphSnapshot<Variable>.
+template <typename Graph>
+void writeEdges(const Graph &ig, std::ofstream &stream) {
   std::set<InterferenceGraph<Variable>::EdgeTy> written_edges;
 
   for (const auto &source : ig.vertices()) {
@@ -60,7 +63,8 @@ void writeEdges(const InterferenceGraph<Variable> &ig, std::ofstream &stream) {
   }
 }
 
-void writeNodes(const InterferenceGraph<Variable> &ig, std::ofstream &stream,
+template <typename Graph>
+void writeNodes(const Graph &ig, std::ofstream &stream,
                 const RegisterAssignment &register_assignment) {
   for (const auto &vertex : ig.vertices()) {
     stream << vertex;
@@ -69,10 +73,17 @@ void writeNodes(const InterferenceGraph<Variable> &ig, std::ofstream &stream,
   }
 }
 
-void writeIG(const InterferenceGraph<Variable> &ig, std::ofstream &stream,
+template <typename Graph>
+void writeIG(const Graph &ig, const std::string &path,
              const RegisterAssignment &register_assignment) {
-  writeNodes(ig, stream, register_assignment);
-  writeEdges(ig, stream);
+  std::ofstream fs;
+  fs.open(path);
+  fs << "graph {" << std::endl;
+  fs << "graph [layout=circo]" << std::endl;
+  writeNodes(ig, fs, register_assignment);
+  writeEdges(ig, fs);
+  fs << "}";
+  fs.close();
 }
 
 };  // namespace
@@ -80,11 +91,11 @@ void writeIG(const InterferenceGraph<Variable> &ig, std::ofstream &stream,
 void IGWriter::write(const InterferenceGraph<Variable> &ig,
                      const std::string &path,
                      const RegisterAssignment &register_assignment) {
-  std::ofstream fs;
-  fs.open(path);
-  fs << "graph {" << std::endl;
-  fs << "graph [layout=circo]" << std::endl;
-  writeIG(ig, fs, register_assignment);
-  fs << "}";
-  fs.close();
-}
\ No newline at end of file
+  writeIG(ig, path, register_assignment);
+}
+
+void IGWriter::write(const GraphSnapshot<Variable> &snapshot,
+                     const std::string &path,
+                     const RegisterAssignment &register_assignment) {
+  writeIG(snapshot, path, register_assignment);
+}
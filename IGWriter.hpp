@@ -45,6 +45,7 @@
 #include <string>
 
 #include "InterferenceGraph.hpp"
+#include "VersionedInterferenceGraph.hpp"
 #include "proj6.hpp"
 
 using namespace proj6;
@@ -54,6 +55,11 @@ class IGWriter {
   static void write(const InterferenceGraph<Variable> &IG,
                     const std::string &path,
                     const RegisterAssignment &registerAssignment);
+
+  // Same output for a snapshot of a VersionedInterferenceGraph.
+  static void write(const GraphSnapshot<Variable> &snapshot,
+                    const std::string &path,
+                    const RegisterAssignment &registerAssignment);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+   ImplicitSearch.hpp
+
+   Breadth-first shortest path over an implicit graph: the neighbors of a
+   state are generated on demand by a callback, so the graph is never
+   materialized. Only the states actually reached are stored, each with
+   its parent and depth.
+
+   The callback is called as expand(state, emit) and must call
+   emit(neighbor) for every neighbor of `state`. With more than one
+   thread it is called concurrently and must be safe for that.
+
+   Bidirectional search runs a second BFS backwards from the goal using
+   the same callback, so it needs a symmetric neighbor relation (as in a
+   word ladder). Every round expands one complete level of whichever
+   frontier is smaller, and the search stops in the round in which the
+   two sides first meet.
+
+   With TraversalOptions::threads > 1, levels of at least
+   parallelThreshold states are split over that many threads. Each thread
+   expands its part into a private list, and the lists are merged in
+   frontier order, so the result does not depend on the thread count.
+
+*/
+
+#ifndef IMPLICIT_SEARCH_H
+#define IMPLICIT_SEARCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct TraversalOptions {
+  bool bidirectional = true;
+
+  unsigned threads = 1;
+
+  // Levels smaller than this are expanded on the calling thread.
+  std::size_t parallelThreshold = 1024;
+};
+
+namespace implicit_search {
+
+template <typename State>
+struct Visit {
+  State parent;
+  unsigned depth;
+};
+
+template <typename State>
+using VisitMap = std::unordered_map<State, Visit<State>, std::hash<State>>;
+
+// Expands every state of `frontier` and returns the (child, parent) pairs
+// of children not yet in `visited`, in frontier order. May contain the
+// same child more than once.
+template <typename State, typename Expand>
+std::vector<std::pair<State, State>> expandLevel(
+    const std::vector<State> &frontier, const VisitMap<State> &visited,
+    Expand &expand, const TraversalOptions &options) {
+  auto expandRange = [&frontier, &visited, &expand](
+                         std::size_t begin, std::size_t end,
+                         std::vector<std::pair<State, State>> &out) {
+    for (std::size_t i = begin; i < end; i++) {
+      const State &parent = frontier[i];
+      expand(parent, [&out, &visited, &parent](const State &child) {
+        if (visited.find(child) == visited.end()) {
+          out.emplace_back(child, parent);
+        }
+      });
+    }
+  };
+
+  std::vector<std::pair<State, State>> children;
+  const unsigned threads = std::max(1u, options.threads);
+  if (threads == 1 || frontier.size() < options.parallelThreshold) {
+    expandRange(0, frontier.size(), children);
+    return children;
+  }
+
+  // `visited` is only read while the workers run.
+  std::vector<std::vector<std::pair<State, State>>> parts(threads);
+  std::vector<std::thread> workers;
+  const std::size_t chunk = (frontier.size() + threads - 1) / threads;
+  for (unsigned t = 0; t < threads; t++) {
+    const std::size_t begin = std::min(frontier.size(), t * chunk);
+    const std::size_t end = std::min(frontier.size(), begin + chunk);
+    workers.emplace_back([&expandRange, &parts, t, begin, end]() {
+      expandRange(begin, end, parts[t]);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (auto &part : parts) {
+    children.insert(children.end(), std::make_move_iterator(part.begin()),
+                    std::make_move_iterator(part.end()));
+  }
+  return children;
+}
+
+// Appends the states from `state` back to its side's root, following
+// parents. The root is its own parent.
+template <typename State>
+void walkToRoot(const VisitMap<State> &visited, State state,
+                std::vector<State> &path) {
+  for (;;) {
+    path.push_back(state);
+    const State &parent = visited.at(state).parent;
+    if (parent == state) {
+      return;
+    }
+    state = parent;
+  }
+}
+
+};  // namespace implicit_search
+
+// Returns a shortest path from start to goal, both included, or an empty
+// vector if goal cannot be reached.
+template <typename State, typename Expand>
+std::vector<State> shortestPath(const State &start, const State &goal,
+                                Expand expand,
+                                const TraversalOptions &options = {}) {
+  using namespace implicit_search;
+
+  if (start == goal) {
+    return {start};
+  }
+
+  VisitMap<State> forward;
+  VisitMap<State> backward;
+  forward.emplace(start, Visit<State>{start, 0});
+  std::vector<State> forwardFrontier = {start};
+  std::vector<State> backwardFrontier;
+  if (options.bidirectional) {
+    backward.emplace(goal, Visit<State>{goal, 0});
+    backwardFrontier.push_back(goal);
+  }
+
+  bool met = false;
+  State meeting = start;
+  unsigned bestLength = 0;
+  while (!met && !forwardFrontier.empty() &&
+         (!options.bidirectional || !backwardFrontier.empty())) {
+    // Ties go forward, so start is always expanded first.
+    const bool goForward =
+        !options.bidirectional ||
+        forwardFrontier.size() <= backwardFrontier.size();
+    VisitMap<State> &visited = goForward ? forward : backward;
+    const VisitMap<State> &other = goForward ? backward : forward;
+    std::vector<State> &frontier = goForward ? forwardFrontier
+                                             : backwardFrontier;
+
+    const unsigned depth = visited.at(frontier.front()).depth + 1;
+    auto children = expandLevel(frontier, visited, expand, options);
+
+    std::vector<State> next;
+    for (auto &[child, parent] : children) {
+      if (!visited.emplace(child, Visit<State>{parent, depth}).second) {
+        continue;
+      }
+      // Among all meetings in this level keep the shortest path.
+      const auto found = other.find(child);
+      if (found != other.end()) {
+        const unsigned length = depth + found->second.depth;
+        if (!met || length < bestLength) {
+          met = true;
+          meeting = child;
+          bestLength = length;
+        }
+      } else if (!options.bidirectional && child == goal) {
+        met = true;
+        meeting = child;
+      }
+      next.push_back(std::move(child));
+    }
+    frontier = std::move(next);
+  }
+
+  std::vector<State> path;
+  if (!met) {
+    return path;
+  }
+  walkToRoot(forward, meeting, path);
+  std::reverse(path.begin(), path.end());
+  if (options.bidirectional) {
+    path.pop_back();
+    walkToRoot(backward, meeting, path);
+  }
+  return path;
+}
+
+#endif
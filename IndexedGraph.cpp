@@ -0,0 +1,91 @@
+/**
+   IndexedGraph.cpp
+
+   See IndexedGraph.hpp for a description of the snapshot layout.
+
+*/
+
+#include "IndexedGraph.hpp"
+
+#include <algorithm>
+
+IndexedGraph::IndexedGraph(const InterferenceGraph<Variable> &ig) {
+  names.reserve(ig.numVertices());
+  ids.reserve(ig.numVertices());
+  ig.forEachVertex([this](const Variable &vertex) {
+    ids[vertex] = static_cast<Id>(names.size());
+    names.push_back(vertex);
+  });
+
+  // Fill the CSR arrays one vertex at a time, keeping each row sorted.
+  offsets.reserve(names.size() + 1);
+  adjacency.reserve(2 * static_cast<std::size_t>(ig.numEdges()));
+  offsets.push_back(0);
+  for (const auto &vertex : names) {
+    const auto rowStart = adjacency.size();
+    ig.forEachNeighbor(vertex, [this](const Variable &neighbor) {
+      adjacency.push_back(ids.at(neighbor));
+    });
+    std::sort(adjacency.begin() + rowStart, adjacency.end());
+    offsets.push_back(static_cast<unsigned>(adjacency.size()));
+  }
+}
+
+IndexedGraph IndexedGraph::relabeled(const std::vector<Id> &order) const {
+  std::vector<Id> newId(size());
+  for (Id i = 0; i < size(); i++) {
+    newId[order[i]] = i;
+  }
+
+  IndexedGraph result;
+  result.names.reserve(names.size());
+  result.ids.reserve(names.size());
+  result.offsets.reserve(offsets.size());
+  result.adjacency.reserve(adjacency.size());
+  result.offsets.push_back(0);
+  for (Id i = 0; i < size(); i++) {
+    const Id v = order[i];
+    result.ids[names[v]] = i;
+    result.names.push_back(names[v]);
+
+    const auto rowStart = result.adjacency.size();
+    for (auto it = neighborsBegin(v); it != neighborsEnd(v); ++it) {
+      result.adjacency.push_back(newId[*it]);
+    }
+    std::sort(result.adjacency.begin() + rowStart, result.adjacency.end());
+    result.offsets.push_back(static_cast<unsigned>(result.adjacency.size()));
+  }
+  return result;
+}
+
+IndexedGraph::Id IndexedGraph::id(const Variable &var) const {
+  const auto it = ids.find(var);
+  if (it == ids.end()) {
+    throw UnknownVertexException(var);
+  }
+  return it->second;
+}
+
+RegisterAssignment IndexedGraph::toAssignment(
+    const std::vector<Register> &colors) const {
+  RegisterAssignment assignment;
+  assignment.reserve(names.size());
+  for (Id v = 0; v < size(); v++) {
+    if (colors[v] != 0) {
+      assignment[names[v]] = colors[v];
+    }
+  }
+  return assignment;
+}
+
+std::vector<Register> IndexedGraph::fromAssignment(
+    const RegisterAssignment &assignment) const {
+  std::vector<Register> colors(names.size(), 0);
+  for (Id v = 0; v < size(); v++) {
+    const auto it = assignment.find(names[v]);
+    if (it != assignment.end()) {
+      colors[v] = it->second;
+    }
+  }
+  return colors;
+}
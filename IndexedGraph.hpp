@@ -0,0 +1,94 @@
+/**
+   IndexedGraph.hpp
+
+   A read-only snapshot of an InterferenceGraph<Variable> where every
+   variable is relabeled to a dense integer id in [0, size()). Neighbor
+   lists are stored sorted in CSR form (one offsets array and one flat
+   neighbor array), so the coloring engines can work over plain integers
+   instead of hashing strings on every neighbor access.
+
+   Names are looked up through a FlatHashMap, so id() costs one probe of
+   an inline array instead of a hash node chase.
+
+   Register assignments are converted to and from a std::vector<Register>
+   indexed by id, where 0 means "no register".
+
+*/
+
+#ifndef INDEXED_GRAPH_H
+#define INDEXED_GRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FlatHashMap.hpp"
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+class IndexedGraph {
+ public:
+  using Id = std::uint32_t;
+
+  IndexedGraph() = default;
+
+  explicit IndexedGraph(const InterferenceGraph<Variable> &ig);
+
+  // Copy of this graph where the vertex with id order[i] gets id i. Names
+  // move with their vertices. `order` must be a permutation of the ids;
+  // see proj6::vertexOrder in VertexOrder.hpp.
+  IndexedGraph relabeled(const std::vector<Id> &order) const;
+
+  Id size() const noexcept { return static_cast<Id>(names.size()); }
+
+  unsigned numEdges() const noexcept {
+    return static_cast<unsigned>(adjacency.size() / 2);
+  }
+
+  unsigned degree(Id v) const noexcept { return offsets[v + 1] - offsets[v]; }
+
+  // Sorted neighbors of v are in [neighborsBegin(v), neighborsEnd(v)).
+  const Id *neighborsBegin(Id v) const noexcept {
+    return adjacency.data() + offsets[v];
+  }
+
+  const Id *neighborsEnd(Id v) const noexcept {
+    return adjacency.data() + offsets[v + 1];
+  }
+
+  // Calls visit(neighbor) for every neighbor of v in increasing order.
+  // Same interface as CompressedGraph, so templated engines (see
+  // GreedyColoring.hpp) can run on either.
+  template <typename Visit>
+  void forEachNeighbor(Id v, Visit visit) const {
+    for (auto it = neighborsBegin(v); it != neighborsEnd(v); ++it) {
+      visit(*it);
+    }
+  }
+
+  const Variable &name(Id v) const { return names.at(v); }
+
+  bool contains(const Variable &var) const { return ids.count(var) > 0; }
+
+  // Throws UnknownVertexException if the variable is not in the graph.
+  Id id(const Variable &var) const;
+
+  // Convert an id-indexed coloring to a RegisterAssignment. Vertices
+  // with register 0 are left out.
+  RegisterAssignment toAssignment(const std::vector<Register> &colors) const;
+
+  // Convert a RegisterAssignment to an id-indexed coloring. Variables
+  // missing from the assignment get register 0.
+  std::vector<Register> fromAssignment(
+      const RegisterAssignment &assignment) const;
+
+ private:
+  std::vector<Variable> names;
+  FlatHashMap<Variable, Id> ids;
+  std::vector<unsigned> offsets;
+  std::vector<Id> adjacency;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/**
+   InputFile.cpp
+
+   See InputFile.hpp. Each decoder pulls compressed bytes from the file in
+   INPUT_BLOCK_BYTES chunks and inflates straight into the caller's
+   buffer.
+
+*/
+
+#include "InputFile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef PROJ6_NO_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PROJ6_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+const std::size_t INPUT_BLOCK_BYTES = 64 * 1024;
+
+const unsigned char GZIP_MAGIC[] = {0x1f, 0x8b};
+const unsigned char ZSTD_MAGIC[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+template <std::size_t N>
+bool startsWith(const unsigned char *data, std::size_t size,
+                const unsigned char (&magic)[N]) {
+  return size >= N && std::equal(magic, magic + N, data);
+}
+
+};  // namespace
+
+class InputFile::Decoder {
+ public:
+  virtual ~Decoder() = default;
+
+  virtual std::size_t read(std::ifstream &file, char *out,
+                           std::size_t size) = 0;
+
+ protected:
+  // Refill `input` from the file; false at the end of the file.
+  static bool fill(std::ifstream &file, std::vector<char> &input,
+                   std::size_t &available) {
+    file.read(input.data(), static_cast<std::streamsize>(input.size()));
+    available = static_cast<std::size_t>(file.gcount());
+    return available > 0;
+  }
+};
+
+namespace {
+
+#ifndef PROJ6_NO_ZLIB
+class GzipDecoder : public InputFile::Decoder {
+ public:
+  explicit GzipDecoder(const std::string &path)
+      : path(path), input(INPUT_BLOCK_BYTES) {
+    // 15 + 16: gzip framing with the largest window.
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+      throw std::runtime_error("Cannot start gzip decoder for " + path);
+    }
+  }
+
+  ~GzipDecoder() override { inflateEnd(&stream); }
+
+  std::size_t read(std::ifstream &file, char *out, std::size_t size) override {
+    stream.next_out = reinterpret_cast<Bytef *>(out);
+    stream.avail_out = static_cast<uInt>(size);
+    while (stream.avail_out > 0 && !finished) {
+      if (stream.avail_in == 0) {
+        std::size_t available = 0;
+        if (!fill(file, input, available)) {
+          if (inMember) {
+            throw std::runtime_error("Truncated gzip data in " + path);
+          }
+          finished = true;
+          break;
+        }
+        stream.next_in = reinterpret_cast<Bytef *>(input.data());
+        stream.avail_in = static_cast<uInt>(available);
+      }
+
+      inMember = true;
+      const int status = inflate(&stream, Z_NO_FLUSH);
+      if (status == Z_STREAM_END) {
+        // Another member may follow (as written by `cat a.gz b.gz`).
+        inMember = false;
+        inflateReset(&stream);
+      } else if (status != Z_OK && status != Z_BUF_ERROR) {
+        throw std::runtime_error("Corrupt gzip data in " + path);
+      }
+    }
+    return size - stream.avail_out;
+  }
+
+ private:
+  std::string path;
+  std::vector<char> input;
+  z_stream stream{};
+  bool inMember = false;
+  bool finished = false;
+};
+#endif
+
+#ifdef PROJ6_WITH_ZSTD
+class ZstdDecoder : public InputFile::Decoder {
+ public:
+  explicit ZstdDecoder(const std::string &path)
+      : path(path), input(ZSTD_DStreamInSize()), context(ZSTD_createDCtx()) {
+    if (context == nullptr) {
+      throw std::runtime_error("Cannot start zstd decoder for " + path);
+    }
+  }
+
+  ~ZstdDecoder() override { ZSTD_freeDCtx(context); }
+
+  std::size_t read(std::ifstream &file, char *out, std::size_t size) override {
+    ZSTD_outBuffer output = {out, size, 0};
+    while (output.pos < output.size) {
+      if (in.pos == in.size) {
+        std::size_t available = 0;
+        if (!fill(file, input, available)) {
+          if (inFrame) {
+            throw std::runtime_error("Truncated zstd data in " + path);
+          }
+          break;
+        }
+        in = {input.data(), available, 0};
+      }
+
+      const std::size_t hint = ZSTD_decompressStream(context, &output, &in);
+      if (ZSTD_isError(hint)) {
+        throw std::runtime_error("Corrupt zstd data in " + path);
+      }
+      // 0 means a frame just ended.
+      inFrame = hint != 0;
+    }
+    return output.pos;
+  }
+
+ private:
+  std::string path;
+  std::vector<char> input;
+  ZSTD_DCtx *context;
+  ZSTD_inBuffer in = {nullptr, 0, 0};
+  bool inFrame = false;
+};
+#endif
+
+};  // namespace
+
+InputFile::InputFile(const std::string &path)
+    : path(path), file(path, std::ios::binary) {
+  if (!file.good()) {
+    throw std::runtime_error("File " + path + " does not exist!");
+  }
+
+  unsigned char magic[4] = {};
+  file.read(reinterpret_cast<char *>(magic), sizeof(magic));
+  const std::size_t got = static_cast<std::size_t>(file.gcount());
+  file.clear();
+  file.seekg(0);
+
+  if (startsWith(magic, got, GZIP_MAGIC)) {
+    fileFormat = Format::Gzip;
+#ifndef PROJ6_NO_ZLIB
+    decoder = std::make_unique<GzipDecoder>(path);
+#endif
+  } else if (startsWith(magic, got, ZSTD_MAGIC)) {
+    fileFormat = Format::Zstd;
+#ifdef PROJ6_WITH_ZSTD
+    decoder = std::make_unique<ZstdDecoder>(path);
+#endif
+  }
+  if (fileFormat != Format::Plain && !decoder) {
+    throw std::runtime_error("File " + path +
+                             " is compressed in a format this build "
+                             "cannot read");
+  }
+}
+
+InputFile::~InputFile() = default;
+
+std::size_t InputFile::read(char *buffer, std::size_t size) {
+  if (decoder) {
+    return decoder->read(file, buffer, size);
+  }
+  file.read(buffer, static_cast<std::streamsize>(size));
+  return static_cast<std::size_t>(file.gcount());
+}
+
+bool InputFile::readLine(std::string &line) {
+  line.clear();
+  if (lineBuffer.empty()) {
+    lineBuffer.resize(INPUT_BLOCK_BYTES);
+  }
+  for (;;) {
+    if (linePos == lineEnd) {
+      linePos = 0;
+      lineEnd = read(lineBuffer.data(), lineBuffer.size());
+      if (lineEnd == 0) {
+        // Like getline, a last line without '\n' still counts.
+        return !line.empty();
+      }
+    }
+    const char *begin = lineBuffer.data() + linePos;
+    const char *end = lineBuffer.data() + lineEnd;
+    const char *newline = std::find(begin, end, '\n');
+    line.append(begin, newline);
+    linePos = static_cast<std::size_t>(newline - lineBuffer.data());
+    if (newline != end) {
+      linePos++;
+      return true;
+    }
+  }
+}
@@ -0,0 +1,62 @@
+/**
+   InputFile.hpp
+
+   Read side of every graph and interval file. Compressed files are
+   recognized by their magic bytes and decompressed as they are read, one
+   block at a time, so a compressed graph never has to exist
+   uncompressed on disk or in memory. Plain files are passed through.
+
+     gzip  always, through zlib (define PROJ6_NO_ZLIB to build without
+           it). Concatenated gzip members are read as one stream.
+     zstd  when built with PROJ6_WITH_ZSTD (and linked with -lzstd).
+
+   A compressed file in a format this build cannot read is an error, not
+   garbage rows.
+
+*/
+
+#ifndef INPUT_FILE_H
+#define INPUT_FILE_H
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class InputFile {
+ public:
+  enum class Format { Plain, Gzip, Zstd };
+
+  // Throws std::runtime_error if the file cannot be opened or is
+  // compressed in a format this build does not support.
+  explicit InputFile(const std::string &path);
+
+  ~InputFile();
+
+  Format format() const noexcept { return fileFormat; }
+
+  // Reads up to `size` bytes of decompressed data into `buffer` and
+  // returns how many were read, 0 at the end of the file. Throws
+  // std::runtime_error on corrupt or truncated compressed data.
+  std::size_t read(char *buffer, std::size_t size);
+
+  // Like std::getline on the decompressed text. Do not mix with read().
+  bool readLine(std::string &line);
+
+  // Implemented per format in InputFile.cpp.
+  class Decoder;
+
+ private:
+  std::string path;
+  std::ifstream file;
+  Format fileFormat = Format::Plain;
+  std::unique_ptr<Decoder> decoder;
+
+  // readLine() buffer; bytes [linePos, lineEnd) are not consumed yet.
+  std::vector<char> lineBuffer;
+  std::size_t linePos = 0;
+  std::size_t lineEnd = 0;
+};
+
+#endif
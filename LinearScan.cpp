@@ -0,0 +1,106 @@
+/**
+   LinearScan.cpp
+
+   See LinearScan.hpp for the interval conventions.
+
+*/
+
+#include "LinearScan.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CSVReader.hpp"
+
+std::vector<LiveInterval> proj6::normalizeIntervals(
+    const std::vector<LiveInterval> &input) {
+  std::vector<LiveInterval> intervals;
+  std::unordered_map<Variable, std::size_t> seen;
+  intervals.reserve(input.size());
+  seen.reserve(input.size());
+
+  for (const auto &interval : input) {
+    const unsigned end = std::max(interval.end, interval.start + 1);
+    const auto it = seen.find(interval.var);
+    if (it == seen.end()) {
+      seen[interval.var] = intervals.size();
+      intervals.push_back({interval.var, interval.start, end});
+    } else {
+      auto &merged = intervals[it->second];
+      merged.start = std::min(merged.start, interval.start);
+      merged.end = std::max(merged.end, end);
+    }
+  }
+
+  std::sort(intervals.begin(), intervals.end(),
+            [](const LiveInterval &a, const LiveInterval &b) {
+              return a.start < b.start || (a.start == b.start && a.end < b.end);
+            });
+  return intervals;
+}
+
+RegisterAssignment proj6::linearScan(
+    const std::vector<LiveInterval> &input, int num_registers) noexcept {
+  const auto intervals = normalizeIntervals(input);
+
+  // Active intervals ordered by end position, and registers handed back by
+  // expired intervals ordered lowest first.
+  using Active = std::pair<unsigned, Register>;
+  std::priority_queue<Active, std::vector<Active>, std::greater<Active>> active;
+  std::priority_queue<Register, std::vector<Register>, std::greater<Register>>
+      freeRegisters;
+  Register nextUnused = 1;
+
+  RegisterAssignment assignment;
+  assignment.reserve(intervals.size());
+  for (const auto &interval : intervals) {
+    while (!active.empty() && active.top().first <= interval.start) {
+      freeRegisters.push(active.top().second);
+      active.pop();
+    }
+
+    Register reg;
+    if (!freeRegisters.empty()) {
+      reg = freeRegisters.top();
+      freeRegisters.pop();
+    } else if (nextUnused <= num_registers) {
+      reg = nextUnused++;
+    } else {
+      return {};
+    }
+
+    assignment[interval.var] = reg;
+    active.push({interval.end, reg});
+  }
+  return assignment;
+}
+
+RegisterAssignment proj6::assignRegistersFromIntervals(
+    const std::string &path_to_intervals, int num_registers) noexcept {
+  return linearScan(CSVReader::loadIntervals(path_to_intervals),
+                    num_registers);
+}
+
+InterferenceGraph<Variable> proj6::buildInterferenceGraph(
+    const std::vector<LiveInterval> &input) {
+  const auto intervals = normalizeIntervals(input);
+
+  InterferenceGraph<Variable> ig;
+  // Intervals that are still live, keyed by end position.
+  std::multimap<unsigned, const Variable *> active;
+  for (const auto &interval : intervals) {
+    active.erase(active.begin(), active.upper_bound(interval.start));
+
+    ig.addVertex(interval.var);
+    for (const auto &[end, var] : active) {
+      ig.addEdge(interval.var, *var);
+    }
+    active.emplace(interval.end, &interval.var);
+  }
+  return ig;
+}
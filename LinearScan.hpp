@@ -0,0 +1,50 @@
+/**
+   LinearScan.hpp
+
+   A fast allocation tier that works directly on live intervals instead of
+   an explicit interference graph. Intervals are visited in order of their
+   start position; intervals that have ended give their register back, and
+   every new interval takes the lowest free register. This is O(n log n) in
+   the number of intervals and, since an interval graph is perfect, uses
+   exactly as many registers as the largest number of overlapping
+   intervals.
+
+   Intervals are half-open, [start, end). An interval with end <= start is
+   treated as live at the single point `start`. A variable listed more than
+   once gets one interval covering all of its rows.
+
+*/
+
+#ifndef LINEAR_SCAN_H
+#define LINEAR_SCAN_H
+
+#include <string>
+#include <vector>
+
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+namespace proj6 {
+
+// Merges repeated variables into one interval each, widens empty
+// intervals to length 1 and sorts by start position.
+std::vector<LiveInterval> normalizeIntervals(
+    const std::vector<LiveInterval> &intervals);
+
+// Returns an empty map if more than num_registers intervals overlap.
+RegisterAssignment linearScan(const std::vector<LiveInterval> &intervals,
+                              int num_registers) noexcept;
+
+// Same as above with the intervals read by CSVReader::loadIntervals.
+RegisterAssignment assignRegistersFromIntervals(
+    const std::string &path_to_intervals, int num_registers) noexcept;
+
+// Sweep-line construction of the interference graph for `intervals`, for
+// when graph-based allocation is still wanted. Costs O(n log n) plus the
+// number of edges.
+InterferenceGraph<Variable> buildInterferenceGraph(
+    const std::vector<LiveInterval> &intervals);
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,288 @@
+/**
+   LocalSearch.cpp
+
+   See LocalSearch.hpp for an overview of the improvement pass.
+
+*/
+
+#include "LocalSearch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "BudgetTracker.hpp"
+#include "VertexOrder.hpp"
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+bool isValidColoring(const IndexedGraph &graph,
+                     const std::vector<Register> &colors) {
+  for (Id v = 0; v < graph.size(); v++) {
+    if (colors[v] < 1) {
+      return false;
+    }
+    for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+      if (colors[*it] == colors[v]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Try to give v a register in [1, k] that none of its neighbors use,
+// swapping one (a, b) Kempe chain if no register is free outright. Kempe
+// swaps never create new conflicts, so a valid part of the coloring stays
+// valid.
+bool kempeRecolor(const IndexedGraph &graph, std::vector<Register> &colors,
+                  Id v, Register k, std::vector<int> &used,
+                  std::vector<Id> &stack, std::vector<char> &visited,
+                  std::vector<char> &isNeighbor) {
+  std::fill(used.begin(), used.end(), 0);
+  for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+    if (colors[*it] >= 1 && colors[*it] <= k) {
+      used[colors[*it]]++;
+    }
+    isNeighbor[*it] = 1;
+  }
+
+  bool recolored = false;
+  for (Register c = 1; c <= k && !recolored; c++) {
+    if (used[c] == 0) {
+      colors[v] = c;
+      recolored = true;
+    }
+  }
+
+  // Free up register a by flipping a/b on every chain that touches an
+  // a-colored neighbor, as long as none of those chains reaches a
+  // b-colored neighbor.
+  for (Register a = 1; a <= k && !recolored; a++) {
+    for (Register b = 1; b <= k && !recolored; b++) {
+      if (a == b || used[a] == 0) {
+        continue;
+      }
+
+      std::vector<Id> chain;
+      bool blocked = false;
+      for (auto it = graph.neighborsBegin(v);
+           it != graph.neighborsEnd(v) && !blocked; ++it) {
+        if (colors[*it] != a || visited[*it]) {
+          continue;
+        }
+        visited[*it] = 1;
+        stack.push_back(*it);
+        while (!stack.empty() && !blocked) {
+          const Id u = stack.back();
+          stack.pop_back();
+          chain.push_back(u);
+          if (colors[u] == b && isNeighbor[u]) {
+            blocked = true;
+          }
+          for (auto w = graph.neighborsBegin(u); w != graph.neighborsEnd(u);
+               ++w) {
+            if (!visited[*w] && (colors[*w] == a || colors[*w] == b)) {
+              visited[*w] = 1;
+              stack.push_back(*w);
+            }
+          }
+        }
+      }
+
+      for (const auto u : stack) {
+        visited[u] = 0;
+      }
+      stack.clear();
+      for (const auto u : chain) {
+        visited[u] = 0;
+        if (!blocked) {
+          colors[u] = colors[u] == a ? b : a;
+        }
+      }
+      if (!blocked) {
+        colors[v] = a;
+        recolored = true;
+      }
+    }
+  }
+
+  for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+    isNeighbor[*it] = 0;
+  }
+  return recolored;
+}
+
+// Standard tabu search over complete colorings with k registers that
+// minimizes the number of conflicting edges. `colors` must already use
+// only registers in [1, k]. Returns true once a conflict-free coloring is
+// reached, false if the budget ran out first.
+bool tabuSearch(const IndexedGraph &graph, std::vector<Register> &colors,
+                Register k, BudgetTracker &tracker, std::mt19937 &rng) {
+  const std::size_t stride = static_cast<std::size_t>(k) + 1;
+  const Id n = graph.size();
+
+  // conflictsWith[v * stride + c] = number of neighbors of v holding c.
+  std::vector<unsigned> conflictsWith(n * stride, 0);
+  long conflicts = 0;
+  for (Id v = 0; v < n; v++) {
+    for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+      conflictsWith[v * stride + colors[*it]]++;
+      if (*it > v && colors[*it] == colors[v]) {
+        conflicts++;
+      }
+    }
+  }
+
+  std::vector<unsigned long> tabuUntil(n * stride, 0);
+  unsigned long step = 0;
+  while (conflicts > 0) {
+    if (tracker.exhausted()) {
+      return false;
+    }
+    step++;
+
+    long bestDelta = 0;
+    Id bestVertex = 0;
+    Register bestColor = 0;
+    unsigned ties = 0;
+    unsigned conflictingVertices = 0;
+    for (Id v = 0; v < n; v++) {
+      const Register current = colors[v];
+      const long here = conflictsWith[v * stride + current];
+      if (here == 0) {
+        continue;
+      }
+      conflictingVertices++;
+      for (Register c = 1; c <= k; c++) {
+        if (c == current) {
+          continue;
+        }
+        const long delta =
+            static_cast<long>(conflictsWith[v * stride + c]) - here;
+        const bool aspiration = conflicts + delta == 0;
+        if (tabuUntil[v * stride + c] > step && !aspiration) {
+          continue;
+        }
+        if (bestColor == 0 || delta < bestDelta) {
+          bestDelta = delta;
+          bestVertex = v;
+          bestColor = c;
+          ties = 1;
+        } else if (delta == bestDelta && rng() % ++ties == 0) {
+          bestVertex = v;
+          bestColor = c;
+        }
+      }
+    }
+
+    // Every move is tabu this step; let the tenures run down.
+    if (bestColor == 0) {
+      continue;
+    }
+
+    const Register old = colors[bestVertex];
+    for (auto it = graph.neighborsBegin(bestVertex);
+         it != graph.neighborsEnd(bestVertex); ++it) {
+      conflictsWith[*it * stride + old]--;
+      conflictsWith[*it * stride + bestColor]++;
+    }
+    colors[bestVertex] = bestColor;
+    conflicts += bestDelta;
+    tabuUntil[bestVertex * stride + old] =
+        step + rng() % 10 + (6 * conflictingVertices) / 10;
+  }
+  return true;
+}
+
+// Register in [1, k] with the fewest neighbors already holding it.
+Register leastConflictingColor(const IndexedGraph &graph,
+                               const std::vector<Register> &colors, Id v,
+                               Register k, std::vector<int> &used) {
+  std::fill(used.begin(), used.end(), 0);
+  for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+    if (colors[*it] >= 1 && colors[*it] <= k) {
+      used[colors[*it]]++;
+    }
+  }
+  Register best = 1;
+  for (Register c = 2; c <= k; c++) {
+    if (used[c] < used[best]) {
+      best = c;
+    }
+  }
+  return best;
+}
+
+};  // namespace
+
+std::vector<Register> proj6::improveColoring(const IndexedGraph &graph,
+                                             std::vector<Register> colors,
+                                             const SearchBudget &budget) {
+  if (budget.time.count() <= 0 && budget.iterations == 0) {
+    return colors;
+  }
+  if (!isValidColoring(graph, colors)) {
+    return colors;
+  }
+
+  BudgetTracker tracker(budget);
+  // Fixed seed so that the same budget gives the same answer run to run.
+  std::mt19937 rng(graph.size());
+
+  Register k = 0;
+  for (const auto c : colors) {
+    k = std::max(k, c);
+  }
+
+  std::vector<int> used(static_cast<std::size_t>(k) + 1);
+  std::vector<Id> stack;
+  std::vector<char> visited(graph.size(), 0);
+  std::vector<char> isNeighbor(graph.size(), 0);
+
+  while (k > 1) {
+    const Register target = k - 1;
+    std::vector<Register> trial = colors;
+
+    // Kempe interchanges first; they are cheap and keep the coloring valid.
+    std::vector<Id> leftover;
+    for (Id v = 0; v < graph.size(); v++) {
+      if (trial[v] == k &&
+          !kempeRecolor(graph, trial, v, target, used, stack, visited,
+                        isNeighbor)) {
+        leftover.push_back(v);
+      }
+      if (tracker.exhausted()) {
+        return colors;
+      }
+    }
+
+    // Whatever could not be moved goes to its least conflicting register
+    // and the tabu search repairs the conflicts.
+    for (const auto v : leftover) {
+      trial[v] = leastConflictingColor(graph, trial, v, target, used);
+    }
+    if (!leftover.empty() && !tabuSearch(graph, trial, target, tracker, rng)) {
+      return colors;
+    }
+
+    colors = std::move(trial);
+    k = target;
+  }
+  return colors;
+}
+
+RegisterAssignment proj6::improveAssignment(
+    const InterferenceGraph<Variable> &ig, const RegisterAssignment &assignment,
+    const SearchBudget &budget) noexcept {
+  // The search sweeps the neighbor lists many times, so renumber the
+  // vertices first to keep those sweeps local.
+  const IndexedGraph indexed(ig);
+  const IndexedGraph graph = indexed.relabeled(
+      vertexOrder(indexed, VertexOrder::ReverseCuthillMcKee));
+  const auto colors =
+      improveColoring(graph, graph.fromAssignment(assignment), budget);
+  return graph.toAssignment(colors);
+}
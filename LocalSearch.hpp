@@ -0,0 +1,41 @@
+/**
+   LocalSearch.hpp
+
+   An optional improvement pass for an already valid register assignment.
+   Starting from k registers, it repeatedly tries to find a valid coloring
+   with k - 1 registers: vertices holding the highest register are first
+   moved with Kempe-chain interchanges, and any that are left in conflict
+   are handed to a tabu search that minimizes the number of interfering
+   pairs sharing a register.
+
+   The search is "anytime": it always keeps the best valid assignment
+   found so far and returns it as soon as the SearchBudget runs out.
+
+*/
+
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <vector>
+
+#include "IndexedGraph.hpp"
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+namespace proj6 {
+
+// Returns an assignment using no more registers than `assignment`. If
+// `assignment` is not a valid coloring of every vertex in `ig` it is
+// returned unchanged.
+RegisterAssignment improveAssignment(const InterferenceGraph<Variable> &ig,
+                                     const RegisterAssignment &assignment,
+                                     const SearchBudget &budget) noexcept;
+
+// Integer-id version of the above, used by the other engines.
+std::vector<Register> improveColoring(const IndexedGraph &graph,
+                                      std::vector<Register> colors,
+                                      const SearchBudget &budget);
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,50 @@
+/**
+   MemoryUsage.hpp
+
+   Byte counts returned by InterferenceGraph::memoryUsage() and
+   CompactInterferenceGraph::memoryUsage(). The numbers are estimates of
+   what the containers hold (object sizes, heap buffers, hash nodes and
+   bucket arrays); allocator headers and padding are not included.
+
+*/
+
+#ifndef MEMORY_USAGE_H
+#define MEMORY_USAGE_H
+
+#include <cstddef>
+#include <string>
+
+struct MemoryUsage {
+  // Vertex names, once per vertex.
+  std::size_t names = 0;
+
+  // Neighbor storage, including any copies of names kept in it.
+  std::size_t adjacency = 0;
+
+  // Hash table nodes, bucket arrays and index slots.
+  std::size_t hashOverhead = 0;
+
+  std::size_t total() const noexcept {
+    return names + adjacency + hashOverhead;
+  }
+};
+
+// Bytes a value owns on the heap beyond sizeof(value). Only std::string
+// owns anything among the vertex types we use.
+template <typename T>
+std::size_t heapBytes(const T &) noexcept {
+  return 0;
+}
+
+inline std::size_t heapBytes(const std::string &s) noexcept {
+  // Strings that fit the small-string buffer own no heap memory. An empty
+  // string's capacity is exactly that buffer size on every library.
+  static const std::size_t inlineCapacity = std::string().capacity();
+  return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0;
+}
+
+// Per-node bookkeeping of std::unordered_{map,set}: the next pointer plus
+// the cached hash code that libstdc++ and MSVC keep for strings.
+const std::size_t HASH_NODE_OVERHEAD = sizeof(void *) + sizeof(std::size_t);
+
+#endif
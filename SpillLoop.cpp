@@ -0,0 +1,179 @@
+/**
+   SpillLoop.cpp
+
+   See SpillLoop.hpp for the rounds and the rewrite rules.
+
+*/
+
+#include "SpillLoop.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "FlatHashMap.hpp"
+#include "LinearScan.hpp"
+
+namespace {
+
+// Scratch state kept across the rounds of one allocation.
+class RoundColorer {
+ public:
+  explicit RoundColorer(int num_registers)
+      : numRegisters(num_registers), takenBy(num_registers + 1, 0) {}
+
+  // Colors `ig` and returns the vertices that got no register, in
+  // coloring order. The registers are in assignment().
+  const std::vector<Variable> &color(const InterferenceGraph<Variable> &ig) {
+    assignment.clear();
+    failed.clear();
+    for (const auto &vertex : ig.getVerticesSortedByDegree()) {
+      // takenBy[r] == stamp means a neighbor of vertex holds register r.
+      stamp++;
+      ig.forEachNeighbor(vertex, [this](const Variable &w) {
+        const auto it = assignment.find(w);
+        if (it != assignment.end()) {
+          takenBy[it->second] = stamp;
+        }
+      });
+
+      Register reg = 1;
+      while (reg <= numRegisters && takenBy[reg] == stamp) {
+        reg++;
+      }
+      if (reg <= numRegisters) {
+        assignment[vertex] = reg;
+      } else {
+        failed.push_back(vertex);
+      }
+    }
+    return failed;
+  }
+
+  // The last round's registers as a RegisterAssignment.
+  RegisterAssignment result() const {
+    RegisterAssignment copy;
+    copy.reserve(assignment.size());
+    for (const auto &[vertex, reg] : assignment) {
+      copy.emplace(vertex, reg);
+    }
+    return copy;
+  }
+
+ private:
+  int numRegisters;
+  // Flat table, since every neighbor of every vertex is looked up here.
+  FlatHashMap<Variable, Register> assignment;
+  std::vector<unsigned long> takenBy;
+  unsigned long stamp = 0;
+  std::vector<Variable> failed;
+};
+
+bool overlaps(const LiveInterval &a, const LiveInterval &b) {
+  return a.start < b.end && b.start < a.end;
+}
+
+// "<base>#<half>", with a counter appended if that name was ever used.
+Variable pieceName(const Variable &base, int half,
+                   std::unordered_set<Variable> &used) {
+  const Variable name = base + "#" + std::to_string(half);
+  Variable candidate = name;
+  for (unsigned n = 2; !used.insert(candidate).second; n++) {
+    candidate = name + "." + std::to_string(n);
+  }
+  return candidate;
+}
+
+};  // namespace
+
+SpillResult proj6::allocateWithSpills(InterferenceGraph<Variable> &ig,
+                                      int num_registers) noexcept {
+  SpillResult result;
+  if (num_registers < 1) {
+    result.spilled.reserve(ig.numVertices());
+    for (const auto &vertex : ig.vertices()) {
+      result.spilled.push_back(vertex);
+      ig.removeVertex(vertex);
+    }
+    return result;
+  }
+
+  RoundColorer colorer(num_registers);
+  for (;;) {
+    result.rounds++;
+    const auto &failed = colorer.color(ig);
+    if (failed.empty()) {
+      result.assignment = colorer.result();
+      return result;
+    }
+    for (const auto &vertex : failed) {
+      ig.removeVertex(vertex);
+      result.spilled.push_back(vertex);
+    }
+  }
+}
+
+SpillResult proj6::allocateWithSpills(
+    const std::vector<LiveInterval> &input, int num_registers) noexcept {
+  std::unordered_map<Variable, LiveInterval> ranges;
+  // Every name that was ever a vertex, so no piece reuses one.
+  std::unordered_set<Variable> used;
+  for (const auto &interval : normalizeIntervals(input)) {
+    ranges.emplace(interval.var, interval);
+    used.insert(interval.var);
+  }
+  SpillResult result;
+  if (num_registers < 1) {
+    for (const auto &[var, range] : ranges) {
+      result.spilled.push_back(var);
+    }
+    return result;
+  }
+
+  InterferenceGraph<Variable> ig = buildInterferenceGraph(input);
+  RoundColorer colorer(num_registers);
+  std::vector<Variable> neighbors;
+  for (;;) {
+    result.rounds++;
+    const auto &failed = colorer.color(ig);
+    if (failed.empty()) {
+      result.assignment = colorer.result();
+      break;
+    }
+
+    for (const auto &vertex : failed) {
+      const LiveInterval range = ranges.at(vertex);
+      neighbors.clear();
+      ig.forEachNeighbor(vertex, [&neighbors](const Variable &w) {
+        neighbors.push_back(w);
+      });
+      ig.removeVertex(vertex);
+      ranges.erase(vertex);
+
+      if (range.end - range.start < 2) {
+        result.spilled.push_back(vertex);
+        continue;
+      }
+
+      const unsigned middle = range.start + (range.end - range.start) / 2;
+      for (const auto &piece :
+           {LiveInterval{pieceName(vertex, 1, used), range.start, middle},
+            LiveInterval{pieceName(vertex, 2, used), middle, range.end}}) {
+        ig.addVertex(piece.var);
+        for (const auto &w : neighbors) {
+          if (overlaps(piece, ranges.at(w))) {
+            ig.addEdge(piece.var, w);
+          }
+        }
+        ranges.emplace(piece.var, piece);
+      }
+    }
+  }
+
+  result.intervals.reserve(ranges.size());
+  for (auto &[var, range] : ranges) {
+    result.intervals.push_back(std::move(range));
+  }
+  return result;
+}
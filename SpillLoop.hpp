@@ -0,0 +1,67 @@
+/**
+   SpillLoop.hpp
+
+   Allocation that does not give up when the registers run out. Each round
+   colors the graph greedily (highest degree first, lowest free register);
+   every vertex that finds no free register becomes a spill candidate.
+   The graph is then rewritten in place and the next round starts:
+
+     - With only a graph, a candidate is spilled: it lives in memory and
+       its vertex is removed.
+     - With live intervals, a candidate is split at the middle of its
+       interval into two pieces named "<var>#1" and "<var>#2". If a name
+       is already taken (a variable of that name, or a piece spilled
+       earlier), a counter is appended: "<var>#1.2", "<var>#1.3", ...
+       So every name in the result is one live range. Each piece
+       interferes only with the neighbors its half overlaps. A candidate
+       whose interval cannot be split (length 1) is spilled.
+
+   Edits go through removeVertex/addVertex/addEdge, so the graph's degree
+   index stays current and ordering a round costs O(n). The assignment map and
+   the scratch buffers are reused from round to round. Every round
+   removes or shortens at least one live range, so the loop always ends.
+
+*/
+
+#ifndef SPILL_LOOP_H
+#define SPILL_LOOP_H
+
+#include <vector>
+
+#include "InterferenceGraph.hpp"
+#include "proj6.hpp"
+
+using namespace proj6;
+
+namespace proj6 {
+
+struct SpillResult {
+  // Registers in [1, num_registers] for every vertex left in the graph,
+  // including the pieces of split variables.
+  RegisterAssignment assignment;
+
+  // Variables (or pieces of them) that live in memory.
+  std::vector<Variable> spilled;
+
+  // Live range of every vertex left in the graph, pieces included. Empty
+  // for the graph-only overload.
+  std::vector<LiveInterval> intervals;
+
+  // Coloring rounds run, 1 if nothing had to be spilled. With
+  // num_registers < 1 everything is spilled without a round.
+  unsigned rounds = 0;
+};
+
+// Spills until the rest of `ig` can be colored, editing `ig` so that it
+// ends up as the graph that was colored.
+SpillResult allocateWithSpills(InterferenceGraph<Variable> &ig,
+                               int num_registers) noexcept;
+
+// Same, but splits live ranges before spilling them. The graph is built
+// once from `intervals` with buildInterferenceGraph.
+SpillResult allocateWithSpills(const std::vector<LiveInterval> &intervals,
+                               int num_registers) noexcept;
+
+};  // namespace proj6
+
+#endif
@@ -0,0 +1,40 @@
+/**
+   Varint.hpp
+
+   LEB128 varints for the binary formats (assignment cache entries and
+   the allocation server protocol): 7 bits per byte, low bits first, high
+   bit set on every byte but the last.
+
+*/
+
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+inline void writeVarint(std::string &out, std::uint64_t n) {
+  while (n >= 0x80) {
+    out.push_back(static_cast<char>((n & 0x7f) | 0x80));
+    n >>= 7;
+  }
+  out.push_back(static_cast<char>(n));
+}
+
+// Reads the varint at in[pos] and advances pos. False if the input ends
+// first or the value does not fit 64 bits.
+inline bool readVarint(const std::string &in, std::size_t &pos,
+                       std::uint64_t &n) {
+  n = 0;
+  for (unsigned shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+    const auto byte = static_cast<unsigned char>(in[pos++]);
+    n |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
@@ -0,0 +1,339 @@
+/**
+   VersionedInterferenceGraph.hpp
+
+   An interference graph that can hand out consistent read-only snapshots
+   while it keeps being edited, so allocation, verification and DOT output
+   can run on one version while the optimizer moves on to the next.
+
+   Storage is copy-on-write at two levels: the vertices are spread over
+   VERSIONED_GRAPH_CHUNKS hash maps (chunks), and every vertex's neighbor
+   set is its own shared_ptr. snapshot() just shares the current root, so
+   it is O(1). The next edit copies the root (the chunk pointers), the one
+   chunk it touches, and the one or two neighbor sets it changes; all other
+   chunks and sets stay shared with the snapshot.
+
+   Snapshots are immutable and may be read from any thread without
+   locking. The VersionedInterferenceGraph itself (edits and snapshot())
+   belongs to one writer thread.
+
+*/
+
+#ifndef VERSIONED_INTERFERENCE_GRAPH_H
+#define VERSIONED_INTERFERENCE_GRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "InterferenceGraph.hpp"
+
+const std::size_t VERSIONED_GRAPH_CHUNKS = 64;
+
+// Shared storage and the read-only queries used by both classes below.
+template <typename T>
+struct VersionedGraphData {
+  using NeighborSet = std::unordered_set<T>;
+  using Chunk = std::unordered_map<T, std::shared_ptr<NeighborSet>>;
+
+  std::array<std::shared_ptr<Chunk>, VERSIONED_GRAPH_CHUNKS> chunks;
+  unsigned numVertices = 0;
+  // Sum of all neighbor set sizes, so every edge is counted twice.
+  unsigned neighborEntries = 0;
+  unsigned long version = 0;
+
+  static std::size_t chunkOf(const T &vertex) {
+    return std::hash<T>{}(vertex) % VERSIONED_GRAPH_CHUNKS;
+  }
+
+  // nullptr if the vertex is not in the graph.
+  const NeighborSet *find(const T &vertex) const {
+    const auto &chunk = chunks[chunkOf(vertex)];
+    if (!chunk) {
+      return nullptr;
+    }
+    const auto it = chunk->find(vertex);
+    return it == chunk->end() ? nullptr : it->second.get();
+  }
+
+  const NeighborSet &at(const T &vertex) const {
+    const NeighborSet *set = find(vertex);
+    if (set == nullptr) {
+      throw UnknownVertexException(vertex);
+    }
+    return *set;
+  }
+
+  template <typename Visit>
+  void forEachVertex(Visit visit) const {
+    for (const auto &chunk : chunks) {
+      if (chunk) {
+        for (const auto &[vertex, set] : *chunk) {
+          visit(vertex, *set);
+        }
+      }
+    }
+  }
+
+  std::unordered_set<T> vertices() const {
+    std::unordered_set<T> result;
+    result.reserve(numVertices);
+    forEachVertex([&result](const T &vertex, const NeighborSet &) {
+      result.insert(vertex);
+    });
+    return result;
+  }
+
+  bool interferes(const T &v, const T &w) const {
+    const NeighborSet &set = at(v);
+    at(w);
+    return set.count(w) > 0;
+  }
+
+  unsigned getMaxDegree() const {
+    std::size_t maxDegree = 0;
+    forEachVertex([&maxDegree](const T &, const NeighborSet &set) {
+      maxDegree = std::max(maxDegree, set.size());
+    });
+    return static_cast<unsigned>(maxDegree);
+  }
+
+  std::vector<T> getVerticesSortedByDegree() const {
+    std::vector<std::pair<std::size_t, const T *>> order;
+    order.reserve(numVertices);
+    forEachVertex([&order](const T &vertex, const NeighborSet &set) {
+      order.emplace_back(set.size(), &vertex);
+    });
+    std::stable_sort(
+        order.begin(), order.end(),
+        [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    std::vector<T> result;
+    result.reserve(order.size());
+    for (const auto &entry : order) {
+      result.push_back(*entry.second);
+    }
+    return result;
+  }
+};
+
+// A frozen version of a VersionedInterferenceGraph. Offers the read-only
+// half of the InterferenceGraph interface.
+template <typename T>
+class GraphSnapshot {
+ public:
+  using EdgeTy = std::pair<T, T>;
+
+  std::unordered_set<T> vertices() const noexcept { return data->vertices(); }
+
+  std::unordered_set<T> neighbors(const T &vertex) const {
+    return data->at(vertex);
+  }
+
+  std::unordered_set<T> getNeighbors(const T &vertex) const {
+    return data->at(vertex);
+  }
+
+  unsigned numVertices() const noexcept { return data->numVertices; }
+
+  unsigned numEdges() const noexcept { return data->neighborEntries / 2; }
+
+  bool interferes(const T &v, const T &w) const {
+    return data->interferes(v, w);
+  }
+
+  unsigned degree(const T &v) const {
+    return static_cast<unsigned>(data->at(v).size());
+  }
+
+  unsigned getMaxDegree() const { return data->getMaxDegree(); }
+
+  std::vector<T> getVerticesSortedByDegree() const {
+    return data->getVerticesSortedByDegree();
+  }
+
+  // Number of edits made to the graph before this snapshot was taken.
+  unsigned long version() const noexcept { return data->version; }
+
+  // Full copy as a plain InterferenceGraph.
+  InterferenceGraph<T> toInterferenceGraph() const {
+    InterferenceGraph<T> ig;
+    data->forEachVertex(
+        [&ig](const T &vertex, const std::unordered_set<T> &set) {
+          ig.addVertex(vertex);
+          for (const auto &neighbor : set) {
+            ig.addEdge(vertex, neighbor);
+          }
+        });
+    return ig;
+  }
+
+ private:
+  template <typename U>
+  friend class VersionedInterferenceGraph;
+
+  explicit GraphSnapshot(std::shared_ptr<const VersionedGraphData<T>> data)
+      : data(std::move(data)) {}
+
+  std::shared_ptr<const VersionedGraphData<T>> data;
+};
+
+template <typename T>
+class VersionedInterferenceGraph {
+ public:
+  using EdgeTy = std::pair<T, T>;
+
+  VersionedInterferenceGraph()
+      : root(std::make_shared<VersionedGraphData<T>>()) {}
+
+  explicit VersionedInterferenceGraph(const InterferenceGraph<T> &ig)
+      : VersionedInterferenceGraph() {
+    for (const auto &vertex : ig.vertices()) {
+      addVertex(vertex);
+      for (const auto &neighbor : ig.getNeighbors(vertex)) {
+        addEdge(vertex, neighbor);
+      }
+    }
+  }
+
+  // O(1): shares the current version with the snapshot.
+  GraphSnapshot<T> snapshot() const { return GraphSnapshot<T>(root); }
+
+  void addEdge(const T &v, const T &w);
+
+  void addVertex(const T &vertex) noexcept;
+
+  void removeEdge(const T &v, const T &w);
+
+  void removeVertex(const T &vertex);
+
+  std::unordered_set<T> vertices() const noexcept { return root->vertices(); }
+
+  std::unordered_set<T> neighbors(const T &vertex) const {
+    return root->at(vertex);
+  }
+
+  std::unordered_set<T> getNeighbors(const T &vertex) const {
+    return root->at(vertex);
+  }
+
+  unsigned numVertices() const noexcept { return root->numVertices; }
+
+  unsigned numEdges() const noexcept { return root->neighborEntries / 2; }
+
+  bool interferes(const T &v, const T &w) const {
+    return root->interferes(v, w);
+  }
+
+  unsigned degree(const T &v) const {
+    return static_cast<unsigned>(root->at(v).size());
+  }
+
+  unsigned getMaxDegree() const { return root->getMaxDegree(); }
+
+  std::vector<T> getVerticesSortedByDegree() const {
+    return root->getVerticesSortedByDegree();
+  }
+
+  unsigned long version() const noexcept { return root->version; }
+
+ private:
+  using Data = VersionedGraphData<T>;
+  using NeighborSet = typename Data::NeighborSet;
+  using Chunk = typename Data::Chunk;
+
+  // Returns a root no snapshot can see, copying the chunk pointers if
+  // one still holds the current root. Only this thread can create new
+  // references, so a use count of 1 cannot go back up behind our back.
+  Data &writableRoot() {
+    if (root.use_count() > 1) {
+      root = std::make_shared<Data>(*root);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    root->version++;
+    return *root;
+  }
+
+  static Chunk &writableChunk(Data &data, const T &vertex) {
+    auto &chunk = data.chunks[Data::chunkOf(vertex)];
+    if (!chunk) {
+      chunk = std::make_shared<Chunk>();
+    } else if (chunk.use_count() > 1) {
+      chunk = std::make_shared<Chunk>(*chunk);
+    }
+    return *chunk;
+  }
+
+  // Neighbor set of `vertex` that is safe to modify, creating the vertex
+  // if it does not exist yet.
+  static NeighborSet &writableSet(Data &data, const T &vertex) {
+    Chunk &chunk = writableChunk(data, vertex);
+    auto &set = chunk[vertex];
+    if (!set) {
+      set = std::make_shared<NeighborSet>();
+      data.numVertices++;
+    } else if (set.use_count() > 1) {
+      set = std::make_shared<NeighborSet>(*set);
+    }
+    return *set;
+  }
+
+  std::shared_ptr<Data> root;
+};
+
+template <typename T>
+void VersionedInterferenceGraph<T>::addVertex(const T &vertex) noexcept {
+  if (root->find(vertex) != nullptr) {
+    return;
+  }
+  writableSet(writableRoot(), vertex);
+}
+
+template <typename T>
+void VersionedInterferenceGraph<T>::addEdge(const T &v, const T &w) {
+  const NeighborSet *existing = root->find(v);
+  if (existing != nullptr && existing->count(w) > 0) {
+    return;
+  }
+
+  Data &data = writableRoot();
+  data.neighborEntries += writableSet(data, v).insert(w).second ? 1 : 0;
+  data.neighborEntries += writableSet(data, w).insert(v).second ? 1 : 0;
+}
+
+template <typename T>
+void VersionedInterferenceGraph<T>::removeEdge(const T &v, const T &w) {
+  if (root->find(v) == nullptr || root->find(w) == nullptr) {
+    throw UnknownEdgeException(v, w);
+  }
+  if (root->find(v)->count(w) == 0) {
+    return;
+  }
+
+  Data &data = writableRoot();
+  data.neighborEntries -= writableSet(data, v).erase(w);
+  data.neighborEntries -= writableSet(data, w).erase(v);
+}
+
+template <typename T>
+void VersionedInterferenceGraph<T>::removeVertex(const T &vertex) {
+  const NeighborSet &set = root->at(vertex);
+  const std::vector<T> neighborList(set.begin(), set.end());
+
+  Data &data = writableRoot();
+  for (const auto &neighbor : neighborList) {
+    if (!(neighbor == vertex)) {
+      data.neighborEntries -= writableSet(data, neighbor).erase(vertex);
+    }
+  }
+  Chunk &chunk = writableChunk(data, vertex);
+  data.neighborEntries -= static_cast<unsigned>(chunk.at(vertex)->size());
+  chunk.erase(vertex);
+  data.numVertices--;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/**
+   VertexOrder.cpp
+
+   See VertexOrder.hpp for the orders offered.
+
+*/
+
+#include "VertexOrder.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+using Id = IndexedGraph::Id;
+
+// Breadth-first order of every component, each started from the first
+// unvisited vertex in `starts`. With `byDegree` the neighbors of a vertex
+// are queued lowest degree first.
+std::vector<Id> breadthFirst(const IndexedGraph &graph,
+                             const std::vector<Id> &starts, bool byDegree) {
+  std::vector<Id> order;
+  order.reserve(graph.size());
+  std::vector<bool> visited(graph.size(), false);
+
+  for (const auto start : starts) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    order.push_back(start);
+    // order[head..] is the queue.
+    for (std::size_t head = order.size() - 1; head < order.size(); head++) {
+      const std::size_t queued = order.size();
+      graph.forEachNeighbor(order[head], [&visited, &order](Id w) {
+        if (!visited[w]) {
+          visited[w] = true;
+          order.push_back(w);
+        }
+      });
+      if (byDegree) {
+        std::stable_sort(order.begin() + queued, order.end(),
+                         [&graph](Id a, Id b) {
+                           return graph.degree(a) < graph.degree(b);
+                         });
+      }
+    }
+  }
+  return order;
+}
+
+};  // namespace
+
+std::vector<IndexedGraph::Id> proj6::vertexOrder(const IndexedGraph &graph,
+                                                 VertexOrder order) {
+  std::vector<Id> ids(graph.size());
+  std::iota(ids.begin(), ids.end(), 0);
+
+  switch (order) {
+    case VertexOrder::Original:
+      return ids;
+    case VertexOrder::DegreeDescending:
+      std::stable_sort(ids.begin(), ids.end(), [&graph](Id a, Id b) {
+        return graph.degree(a) > graph.degree(b);
+      });
+      return ids;
+    case VertexOrder::BreadthFirst:
+      return breadthFirst(graph, ids, false);
+    case VertexOrder::ReverseCuthillMcKee: {
+      std::stable_sort(ids.begin(), ids.end(), [&graph](Id a, Id b) {
+        return graph.degree(a) < graph.degree(b);
+      });
+      auto result = breadthFirst(graph, ids, true);
+      std::reverse(result.begin(), result.end());
+      return result;
+    }
+  }
+  return ids;
+}
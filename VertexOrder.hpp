@@ -0,0 +1,51 @@
+/**
+   VertexOrder.hpp
+
+   Cache-locality relabeling for IndexedGraph and CompressedGraph. The
+   ids IndexedGraph hands out follow hash order, so the neighbors of a
+   vertex are scattered over the whole id range. Renumbering the vertices
+   so that neighbors get nearby ids keeps the engines' per-vertex arrays
+   warm in cache and makes CompressedGraph's gaps small.
+
+   vertexOrder() computes the permutation and IndexedGraph::relabeled()
+   applies it. Names travel with their vertices, so name(), id() and
+   toAssignment() on the relabeled graph still map results back to the
+   original variables.
+
+   AllocatorContext, the Exact engine and improveAssignment() color a
+   Reverse Cuthill-McKee relabeling of the graph they are given.
+
+*/
+
+#ifndef VERTEX_ORDER_H
+#define VERTEX_ORDER_H
+
+#include <vector>
+
+#include "IndexedGraph.hpp"
+
+namespace proj6 {
+
+enum class VertexOrder {
+  // Keep the ids as they are.
+  Original,
+
+  // Highest degree first, the order the greedy engines visit vertices in.
+  DegreeDescending,
+
+  // Breadth-first from the lowest id of every connected component.
+  BreadthFirst,
+
+  // Reverse Cuthill-McKee: breadth-first from a lowest-degree vertex of
+  // every component, neighbors by increasing degree, then reversed.
+  // Keeps neighbor ids close together (a small bandwidth).
+  ReverseCuthillMcKee,
+};
+
+// order[new id] == old id.
+std::vector<IndexedGraph::Id> vertexOrder(const IndexedGraph &graph,
+                                          VertexOrder order);
+
+};  // namespace proj6
+
+#endif
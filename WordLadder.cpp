@@ -0,0 +1,93 @@
+/**
+   WordLadder.cpp
+
+   See WordLadder.hpp.
+
+*/
+
+#include "WordLadder.hpp"
+
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+WordDictionary::WordDictionary(const std::vector<std::string> &list)
+    : words(list.begin(), list.end()) {
+  indexPatterns();
+}
+
+WordDictionary::WordDictionary(const WordDictionary &other)
+    : words(other.words) {
+  indexPatterns();
+}
+
+WordDictionary::WordDictionary(WordDictionary &&other) noexcept
+    : words(std::move(other.words)), patterns(std::move(other.patterns)) {
+  other.words.clear();
+  other.patterns.clear();
+}
+
+WordDictionary &WordDictionary::operator=(const WordDictionary &other) {
+  if (this != &other) {
+    words = other.words;
+    patterns.clear();
+    indexPatterns();
+  }
+  return *this;
+}
+
+WordDictionary &WordDictionary::operator=(WordDictionary &&other) noexcept {
+  if (this != &other) {
+    words = std::move(other.words);
+    patterns = std::move(other.patterns);
+    other.words.clear();
+    other.patterns.clear();
+  }
+  return *this;
+}
+
+void WordDictionary::indexPatterns() {
+  for (const auto &word : words) {
+    std::string pattern = word;
+    for (std::size_t i = 0; i < word.size(); i++) {
+      pattern[i] = WILDCARD;
+      patterns[pattern].push_back(&word);
+      pattern[i] = word[i];
+    }
+  }
+}
+
+WordDictionary WordDictionary::load(const std::string &path) {
+  std::ifstream file_stream(path);
+  if (!file_stream.good()) {
+    throw std::runtime_error("File " + path + " does not exist!");
+  }
+
+  std::vector<std::string> list;
+  std::string line;
+  while (std::getline(file_stream, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      list.push_back(line);
+    }
+  }
+  return WordDictionary(list);
+}
+
+std::vector<std::string> wordLadder(const WordDictionary &dictionary,
+                                    const std::string &start,
+                                    const std::string &goal,
+                                    const TraversalOptions &options) {
+  if (start != goal &&
+      (!dictionary.contains(goal) || start.size() != goal.size())) {
+    return {};
+  }
+  return shortestPath(
+      start, goal,
+      [&dictionary](const std::string &word, auto emit) {
+        dictionary.forEachNeighbor(word, emit);
+      },
+      options);
+}
@@ -0,0 +1,86 @@
+/**
+   WordLadder.hpp
+
+   Word ladder over an implicit graph: two words are adjacent if they
+   have the same length and differ in exactly one letter. The graph is
+   never built. Instead the dictionary indexes every word under each of
+   its wildcard patterns ("cat" under "*at", "c*t" and "ca*"), and the
+   neighbors of a word are the other words sharing one of its patterns.
+   The shortest ladder is found with shortestPath() from
+   ImplicitSearch.hpp.
+
+*/
+
+#ifndef WORD_LADDER_H
+#define WORD_LADDER_H
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ImplicitSearch.hpp"
+
+class WordDictionary {
+ public:
+  explicit WordDictionary(const std::vector<std::string> &words);
+
+  // `patterns` points into `words`, so copies rebuild it. Moves keep it
+  // (set nodes move with the set) and leave the source empty.
+  WordDictionary(const WordDictionary &other);
+
+  WordDictionary(WordDictionary &&other) noexcept;
+
+  WordDictionary &operator=(const WordDictionary &other);
+
+  WordDictionary &operator=(WordDictionary &&other) noexcept;
+
+  // One word per line; blank lines are skipped. Throws std::runtime_error
+  // if the file cannot be opened.
+  static WordDictionary load(const std::string &path);
+
+  bool contains(const std::string &word) const {
+    return words.count(word) > 0;
+  }
+
+  std::size_t size() const noexcept { return words.size(); }
+
+  // Calls emit(neighbor) for every dictionary word one letter away from
+  // `word`. `word` itself does not have to be in the dictionary.
+  template <typename Emit>
+  void forEachNeighbor(const std::string &word, Emit emit) const {
+    std::string pattern = word;
+    for (std::size_t i = 0; i < word.size(); i++) {
+      pattern[i] = WILDCARD;
+      const auto it = patterns.find(pattern);
+      if (it != patterns.end()) {
+        for (const std::string *neighbor : it->second) {
+          if (*neighbor != word) {
+            emit(*neighbor);
+          }
+        }
+      }
+      pattern[i] = word[i];
+    }
+  }
+
+ private:
+  static const char WILDCARD = '*';
+
+  // Fills `patterns` from `words`.
+  void indexPatterns();
+
+  std::unordered_set<std::string> words;
+
+  // Pattern -> words matching it, pointing at the keys of `words`.
+  std::unordered_map<std::string, std::vector<const std::string *>> patterns;
+};
+
+// Shortest ladder from start to goal, both included, where every word
+// after start is in the dictionary. Empty if there is none.
+std::vector<std::string> wordLadder(const WordDictionary &dictionary,
+                                    const std::string &start,
+                                    const std::string &goal,
+                                    const TraversalOptions &options = {});
+
+#endif
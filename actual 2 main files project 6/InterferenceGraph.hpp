@@ -8,6 +8,10 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "MemoryUsage.hpp"
 
 using namespace std;
 
@@ -39,6 +43,9 @@ class UnknownEdgeException : public std::runtime_error {
 
 // ONLY be tested with strings.
 
+template <typename T>
+class ConcurrentGraphBuilder;
+
 template <typename T>
 class InterferenceGraph {
  public:
@@ -52,6 +59,20 @@ class InterferenceGraph {
 
   InterferenceGraph();
 
+  // The degree index points into adjacencyList, so copies rebuild it.
+
+  // Moves keep it (hash map nodes move with the map) and leave the
+
+  // source an empty graph.
+
+  InterferenceGraph(const InterferenceGraph &other);
+
+  InterferenceGraph(InterferenceGraph &&other) noexcept;
+
+  InterferenceGraph &operator=(const InterferenceGraph &other);
+
+  InterferenceGraph &operator=(InterferenceGraph &&other) noexcept;
+
   ~InterferenceGraph();
 
   void addEdge(const T &v, const T &w);
@@ -80,7 +101,47 @@ class InterferenceGraph {
 
   std::unordered_set<T> getNeighbors(const T &vertex) const;
 
+  // Calls visit(neighbor) for every neighbor of vertex without copying
+
+  // the neighbor set. Throws UnknownVertexException like getNeighbors.
+
+  template <typename Visit>
+  void forEachNeighbor(const T &vertex, Visit visit) const;
+
+  // Calls visit(vertex) for every vertex without copying the vertex set.
+
+  template <typename Visit>
+  void forEachVertex(Visit visit) const;
+
+  // Estimated bytes used by the graph, see MemoryUsage.hpp.
+
+  MemoryUsage memoryUsage() const noexcept;
+
  private:
+  // ConcurrentGraphBuilder::build() splices its shards into adjacencyList.
+
+  friend class ConcurrentGraphBuilder<T>;
+
+  using Entry = typename std::unordered_map<T, std::unordered_set<T>>::iterator;
+
+  // Returns the entry for vertex, adding the vertex if it is missing.
+
+  Entry findOrAdd(const T &vertex);
+
+  // Move the vertex of `entry` from the bucket for oldDegree to the
+
+  // bucket for its current degree.
+
+  void updateDegree(Entry entry, unsigned oldDegree);
+
+  // Recompute neighborEntries and the degree index from adjacencyList.
+
+  void rebuildDegreeIndex();
+
+  // Leaves a moved-from graph empty and consistent.
+
+  void clearAfterMove() noexcept;
+
   // Private member variables here.
 
   // This is the adjacencyList that will be used to store the
@@ -92,14 +153,154 @@ class InterferenceGraph {
   // easily find the neighbors of a vertex.
 
   std::unordered_map<T, std::unordered_set<T>> adjacencyList;
+
+  // Sum of all neighbor set sizes, so every edge is counted twice.
+
+  unsigned neighborEntries = 0;
+
+  // degreeBuckets[d] holds the vertices of degree d, as pointers to the
+
+  // keys in adjacencyList (hash map nodes never move). maxDegree is the
+
+  // highest non-empty bucket. Both are kept up to date by every edit, so
+
+  // numEdges() and getMaxDegree() are O(1) and getVerticesSortedByDegree()
+
+  // is a walk over the buckets.
+
+  std::vector<std::unordered_set<const T *>> degreeBuckets;
+
+  unsigned maxDegree = 0;
 };
 
 template <typename T>
 InterferenceGraph<T>::InterferenceGraph() {}
 
+template <typename T>
+InterferenceGraph<T>::InterferenceGraph(const InterferenceGraph &other)
+    : adjacencyList(other.adjacencyList) {
+  rebuildDegreeIndex();
+}
+
+template <typename T>
+InterferenceGraph<T> &InterferenceGraph<T>::operator=(
+    const InterferenceGraph &other) {
+  if (this != &other) {
+    adjacencyList = other.adjacencyList;
+
+    rebuildDegreeIndex();
+  }
+
+  return *this;
+}
+
+template <typename T>
+InterferenceGraph<T>::InterferenceGraph(InterferenceGraph &&other) noexcept
+    : adjacencyList(std::move(other.adjacencyList)),
+      neighborEntries(other.neighborEntries),
+      degreeBuckets(std::move(other.degreeBuckets)),
+      maxDegree(other.maxDegree) {
+  other.clearAfterMove();
+}
+
+template <typename T>
+InterferenceGraph<T> &InterferenceGraph<T>::operator=(
+    InterferenceGraph &&other) noexcept {
+  if (this != &other) {
+    adjacencyList = std::move(other.adjacencyList);
+
+    degreeBuckets = std::move(other.degreeBuckets);
+
+    neighborEntries = other.neighborEntries;
+
+    maxDegree = other.maxDegree;
+
+    other.clearAfterMove();
+  }
+
+  return *this;
+}
+
+template <typename T>
+void InterferenceGraph<T>::clearAfterMove() noexcept {
+  adjacencyList.clear();
+
+  degreeBuckets.clear();
+
+  neighborEntries = 0;
+
+  maxDegree = 0;
+}
+
 template <typename T>
 InterferenceGraph<T>::~InterferenceGraph() {}
 
+template <typename T>
+typename InterferenceGraph<T>::Entry InterferenceGraph<T>::findOrAdd(
+    const T &vertex) {
+  auto [entry, added] = adjacencyList.try_emplace(vertex);
+
+  if (added) {
+    if (degreeBuckets.empty()) {
+      degreeBuckets.emplace_back();
+    }
+
+    degreeBuckets[0].insert(&entry->first);
+  }
+
+  return entry;
+}
+
+template <typename T>
+void InterferenceGraph<T>::updateDegree(Entry entry, unsigned oldDegree) {
+  const unsigned newDegree = static_cast<unsigned>(entry->second.size());
+
+  if (newDegree == oldDegree) {
+    return;
+  }
+
+  degreeBuckets[oldDegree].erase(&entry->first);
+
+  if (newDegree >= degreeBuckets.size()) {
+    degreeBuckets.resize(newDegree + 1);
+  }
+
+  degreeBuckets[newDegree].insert(&entry->first);
+
+  if (newDegree > maxDegree) {
+    maxDegree = newDegree;
+  }
+
+  // degrees only change by one at a time, so this loop is short
+
+  while (maxDegree > 0 && degreeBuckets[maxDegree].empty()) {
+    maxDegree--;
+  }
+}
+
+template <typename T>
+void InterferenceGraph<T>::rebuildDegreeIndex() {
+  neighborEntries = 0;
+
+  maxDegree = 0;
+
+  degreeBuckets.clear();
+
+  for (auto const &[vertex, neighbors] : adjacencyList) {
+    const unsigned d = static_cast<unsigned>(neighbors.size());
+
+    if (d >= degreeBuckets.size()) {
+      degreeBuckets.resize(d + 1);
+    }
+
+    degreeBuckets[d].insert(&vertex);
+
+    neighborEntries += d;
+
+    maxDegree = std::max(maxDegree, d);
+  }
+}
+
 template <typename T>
 std::unordered_set<T> InterferenceGraph<T>::neighbors(const T &vertex) const {
   std::unordered_set<T> neighbors;
@@ -142,23 +343,29 @@ unsigned InterferenceGraph<T>::numVertices() const noexcept {
 
 template <typename T>
 unsigned InterferenceGraph<T>::numEdges() const noexcept {
-  unsigned int numEdges = 0;
+  // we divide by 2 because every edge is in two neighbor sets
 
-  for (const auto &[vertex, neighbors] : adjacencyList) {
-    numEdges += static_cast<unsigned>(neighbors.size());
-  }
-
-  // we divide numEdges by 2 because we are counting each edge twice
-
-  return numEdges / 2;
+  return neighborEntries / 2;
 }
 
 template <typename T>
 
 void InterferenceGraph<T>::addEdge(const T &v, const T &w) {
-  adjacencyList[v].insert(w);
+  Entry first = findOrAdd(v);
+
+  Entry second = findOrAdd(w);
+
+  if (first->second.insert(w).second) {
+    neighborEntries++;
 
-  adjacencyList[w].insert(v);
+    updateDegree(first, static_cast<unsigned>(first->second.size() - 1));
+  }
+
+  if (second->second.insert(v).second) {
+    neighborEntries++;
+
+    updateDegree(second, static_cast<unsigned>(second->second.size() - 1));
+  }
 }
 
 template <typename T>
@@ -166,13 +373,24 @@ template <typename T>
 void InterferenceGraph<T>::removeEdge(const T &v, const T &w) {
   // Check if the vertices exist in the adjacencyList
 
-  if (adjacencyList.find(v) != adjacencyList.end() &&
-      adjacencyList.find(w) != adjacencyList.end()) {
+  Entry first = adjacencyList.find(v);
+
+  Entry second = adjacencyList.find(w);
+
+  if (first != adjacencyList.end() && second != adjacencyList.end()) {
     // if vertices exist, then remove the edge
 
-    adjacencyList[v].erase(w);
+    if (first->second.erase(w) > 0) {
+      neighborEntries--;
 
-    adjacencyList[w].erase(v);
+      updateDegree(first, static_cast<unsigned>(first->second.size() + 1));
+    }
+
+    if (second->second.erase(v) > 0) {
+      neighborEntries--;
+
+      updateDegree(second, static_cast<unsigned>(second->second.size() + 1));
+    }
 
   }
 
@@ -188,9 +406,7 @@ template <typename T>
 void InterferenceGraph<T>::addVertex(const T &vertex) noexcept {
   // Make sure vertex is already not in adjacencyList before adding
 
-  if (adjacencyList.find(vertex) == adjacencyList.end()) {
-    adjacencyList[vertex] = std::unordered_set<T>{};
-  }
+  findOrAdd(vertex);
 }
 
 template <typename T>
@@ -198,16 +414,40 @@ template <typename T>
 void InterferenceGraph<T>::removeVertex(const T &vertex) {
   // Check if the vertex exists in the adjacencyList or not
 
-  if (adjacencyList.find(vertex) != adjacencyList.end()) {
-    for (auto neighbor : adjacencyList[vertex]) {
-      // remove vertex from neighbor's set.
+  Entry entry = adjacencyList.find(vertex);
+
+  if (entry != adjacencyList.end()) {
+    for (auto const &neighbor : entry->second) {
+      // remove vertex from neighbor's set. A self-loop is dropped with
+
+      // the vertex's own set below.
 
-      adjacencyList[neighbor].erase(vertex);
+      if (neighbor == vertex) {
+        continue;
+      }
+
+      Entry other = adjacencyList.find(neighbor);
+
+      other->second.erase(vertex);
+
+      neighborEntries--;
+
+      updateDegree(other, static_cast<unsigned>(other->second.size() + 1));
     }
 
-    // remove the vertex from the adjacencyList
+    // remove the vertex from its degree bucket and the adjacencyList
+
+    const unsigned d = static_cast<unsigned>(entry->second.size());
 
-    adjacencyList.erase(vertex);
+    neighborEntries -= d;
+
+    degreeBuckets[d].erase(&entry->first);
+
+    while (maxDegree > 0 && degreeBuckets[maxDegree].empty()) {
+      maxDegree--;
+    }
+
+    adjacencyList.erase(entry);
 
   }
 
@@ -255,21 +495,11 @@ unsigned InterferenceGraph<T>::degree(const T &v) const {
   }
 }
 
-// added getMaxDegree function that iterates through the adjacencyList
-
-// and returns the max degree of the graph
+// max degree of the graph, kept up to date by the degree index
 
 template <typename T>
 
 unsigned InterferenceGraph<T>::getMaxDegree() const {
-  unsigned maxDegree = 0;
-
-  for (auto const &[vertex, neighbors] : adjacencyList) {
-    if (neighbors.size() > maxDegree) {
-      maxDegree = neighbors.size();
-    }
-  }
-
   return maxDegree;
 }
 
@@ -280,24 +510,13 @@ template <typename T>
 std::vector<T> InterferenceGraph<T>::getVerticesSortedByDegree() const {
   std::vector<T> verticesSortedByDegree;
 
-  // add all vertices to a vector
-
-  for (auto const &[vertex, neighbors] : adjacencyList) {
-    verticesSortedByDegree.push_back(vertex);
-  }
-
-  // actual sorting in DESCENDING order
-
-  for (int i = 0; i < verticesSortedByDegree.size(); i++) {
-    for (int j = i + 1; j < verticesSortedByDegree.size(); j++) {
-      if (degree(verticesSortedByDegree[i]) <
-          degree(verticesSortedByDegree[j])) {
-        T temp = verticesSortedByDegree[i];
+  verticesSortedByDegree.reserve(adjacencyList.size());
 
-        verticesSortedByDegree[i] = verticesSortedByDegree[j];
+  // walk the degree buckets from the highest degree down
 
-        verticesSortedByDegree[j] = temp;
-      }
+  for (std::size_t d = degreeBuckets.size(); d-- > 0;) {
+    for (const T *vertex : degreeBuckets[d]) {
+      verticesSortedByDegree.push_back(*vertex);
     }
   }
 
@@ -318,4 +537,66 @@ std::unordered_set<T> InterferenceGraph<T>::getNeighbors(
   }
 }
 
+template <typename T>
+template <typename Visit>
+void InterferenceGraph<T>::forEachNeighbor(const T &vertex,
+                                           Visit visit) const {
+  auto entry = adjacencyList.find(vertex);
+
+  if (entry == adjacencyList.end()) {
+    throw UnknownVertexException(vertex);
+  }
+
+  for (auto const &neighbor : entry->second) {
+    visit(neighbor);
+  }
+}
+
+template <typename T>
+template <typename Visit>
+void InterferenceGraph<T>::forEachVertex(Visit visit) const {
+  for (auto const &[vertex, neighbors] : adjacencyList) {
+    visit(vertex);
+  }
+}
+
+template <typename T>
+
+MemoryUsage InterferenceGraph<T>::memoryUsage() const noexcept {
+  MemoryUsage usage;
+
+  // the outer map: one node per vertex holding the name and its set
+
+  usage.hashOverhead += sizeof(adjacencyList) +
+                        adjacencyList.bucket_count() * sizeof(void *) +
+                        adjacencyList.size() * HASH_NODE_OVERHEAD;
+
+  for (const auto &[vertex, neighbors] : adjacencyList) {
+    usage.names += sizeof(T) + heapBytes(vertex);
+
+    usage.adjacency += sizeof(neighbors);
+
+    // every neighbor is a full copy of the name in its own node
+
+    for (const auto &neighbor : neighbors) {
+      usage.adjacency += sizeof(T) + heapBytes(neighbor);
+    }
+
+    usage.hashOverhead += neighbors.bucket_count() * sizeof(void *) +
+                          neighbors.size() * HASH_NODE_OVERHEAD;
+  }
+
+  // the degree index: one pointer node per vertex
+
+  usage.hashOverhead +=
+      degreeBuckets.capacity() * sizeof(std::unordered_set<const T *>);
+
+  for (const auto &bucket : degreeBuckets) {
+    usage.hashOverhead += bucket.bucket_count() * sizeof(void *) +
+                          bucket.size() * (sizeof(void *) + sizeof(void *));
+  }
+
+  return usage;
+}
+
 #endif
@@ -1,52 +1,239 @@
 #include "proj6.hpp"
 #include "CSVReader.hpp"
 
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 
+#include "BitOps.hpp"
+#include "ExactColoring.hpp"
+#include "FlatHashMap.hpp"
+#include "GraphClass.hpp"
+#include "IndexedGraph.hpp"
 #include "InterferenceGraph.hpp"
+#include "LocalSearch.hpp"
+#include "VersionedInterferenceGraph.hpp"
+#include "VertexOrder.hpp"
 
 using namespace proj6;
 
-// assignRegisters
-//
-// This is where you implement the register allocation algorithm
-// as mentioned in the README. Remember, you must allocate at MOST
-// d(G) + 1 registers where d(G) is the maximum degree of the graph G.
-// If num_registers is not enough registers to accomodate the passed in
-// graph you should return an empty map. You MUST use registers in the
-// range [1, num_registers] inclusive.
-RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
-                                          int num_registers) noexcept {
-  InterferenceGraph<Variable> ig = CSVReader::load(path_to_graph);
+namespace {
 
+// Welsh-Powell coloring of an already loaded graph whose largest degree
+// is `maxDegree`. Shared by the assignRegisters overloads; Graph is
+// InterferenceGraph<Variable> or GraphSnapshot<Variable>.
+template <typename Graph>
+RegisterAssignment colorGraph(const Graph &ig, int num_registers,
+                              unsigned maxDegree) {
   RegisterAssignment assignment; // create an unordered_map type RegisterAssignment assignment
 
   // Check if the number of registers is sufficient for the graph
-  unsigned maxDegree = ig.getMaxDegree(); // Max degree of graph ig
   // if the number of registers is not sufficient, return empty map.
-  if (maxDegree + 1 > num_registers){
+  if (num_registers < 0 || maxDegree + 1 > static_cast<unsigned>(num_registers)){
     return assignment;
   }
 
   // sort the vertices in decreasing order of the degree
   auto sortedVertices = ig.getVerticesSortedByDegree();
 
+  // The registers chosen so far live in a flat hash table
+  // (FlatHashMap.hpp), which is only copied into the result at the end.
+  // No register above maxDegree + 1 is ever chosen, so the registers
+  // taken by the current vertex's neighbors fit a vector indexed by
+  // register: lastSeen[r] == stamp means a neighbor holds r. It is
+  // reused for every vertex without clearing.
+  FlatHashMap<Variable, Register> chosen;
+  chosen.reserve(sortedVertices.size());
+  std::vector<std::size_t> lastSeen(static_cast<std::size_t>(maxDegree) + 2, 0);
+  std::size_t stamp = 0;
+
   // Allocate the registers to vertices in the order given by sortedVertices.
   for (auto const& vertex: sortedVertices){
-    // Create a set of already-assigned registers that interfere with this vertex
-    std::unordered_set<Register> interferingRegisters;
+    // Mark the already-assigned registers that interfere with this vertex
+    stamp++;
     for (const auto& neighbor : ig.getNeighbors(vertex)){
-      interferingRegisters.insert(assignment[neighbor]);
+      const auto it = chosen.find(neighbor);
+      if (it != chosen.end()){
+        lastSeen[it->second] = stamp;
+      }
     }
     // Find the lowest-numbered register that does not interfere with any neighbors
     Register chosenRegister = 1;
-    while (interferingRegisters.find(chosenRegister) != interferingRegisters.end()){
+    while (lastSeen[chosenRegister] == stamp){
       chosenRegister++;
     }
-    assignment[vertex] = chosenRegister;
+    chosen[vertex] = chosenRegister;
+  }
+
+  assignment.reserve(chosen.size());
+  for (const auto& [vertex, reg] : chosen){
+    assignment.emplace(vertex, reg);
   }
   return assignment;
-}
\ No newline at end of file
+}
+
+// Welsh-Powell over integer ids with one RegisterMask per vertex. The
+// registers a vertex can take are (allowed & ~taken-by-neighbors), so the
+// constraints cost one AND per vertex and nothing is allocated inside the
+// loop.
+RegisterAssignment colorGraphConstrained(
+    const IndexedGraph &graph, int num_registers,
+    const RegisterConstraints &constraints) {
+  using Id = IndexedGraph::Id;
+
+  const RegisterMask allRegisters =
+      num_registers == MAX_CONSTRAINED_REGISTERS
+          ? ~RegisterMask(0)
+          : (RegisterMask(1) << num_registers) - 1;
+
+  std::vector<RegisterMask> allowed(graph.size(), allRegisters);
+  for (const auto &[var, mask] : constraints.allowed) {
+    if (graph.contains(var)) {
+      allowed[graph.id(var)] &= mask;
+    }
+  }
+
+  std::vector<Register> colors(graph.size(), 0);
+  for (const auto &[var, reg] : constraints.precolored) {
+    if (!graph.contains(var)) {
+      continue;
+    }
+    const Id v = graph.id(var);
+    if (reg < 1 || reg > num_registers ||
+        (allowed[v] & (RegisterMask(1) << (reg - 1))) == 0) {
+      return {};
+    }
+    colors[v] = reg;
+  }
+
+  // Most constrained vertices first, then by decreasing degree.
+  std::vector<Id> order(graph.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](Id a, Id b) {
+    const unsigned choicesA = popcount(allowed[a]);
+    const unsigned choicesB = popcount(allowed[b]);
+    if (choicesA != choicesB) {
+      return choicesA < choicesB;
+    }
+    return graph.degree(a) > graph.degree(b);
+  });
+
+  for (const auto v : order) {
+    RegisterMask taken = 0;
+    for (auto it = graph.neighborsBegin(v); it != graph.neighborsEnd(v); ++it) {
+      if (colors[*it] != 0) {
+        taken |= RegisterMask(1) << (colors[*it] - 1);
+      }
+    }
+
+    if (colors[v] != 0) {
+      // Two interfering precolored variables can never be satisfied.
+      if (taken & (RegisterMask(1) << (colors[v] - 1))) {
+        return {};
+      }
+      continue;
+    }
+
+    const RegisterMask free = allowed[v] & ~taken;
+    if (free == 0) {
+      return {};
+    }
+    colors[v] = static_cast<Register>(lowestBit(free)) + 1;
+  }
+
+  return graph.toAssignment(colors);
+}
+
+};  // namespace
+
+// assignRegisters
+//
+// This is where you implement the register allocation algorithm
+// as mentioned in the README. Remember, you must allocate at MOST
+// d(G) + 1 registers where d(G) is the maximum degree of the graph G.
+// If num_registers is not enough registers to accomodate the passed in
+// graph you should return an empty map. You MUST use registers in the
+// range [1, num_registers] inclusive.
+RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
+                                          int num_registers) noexcept {
+  const InterferenceGraph<Variable> ig =
+      CSVReader::loadPipelined(path_to_graph);
+  return colorGraph(ig, num_registers, ig.getMaxDegree());
+}
+
+RegisterAssignment proj6::assignRegisters(
+    const InterferenceGraph<Variable> &ig, int num_registers) noexcept {
+  return colorGraph(ig, num_registers, ig.getMaxDegree());
+}
+
+RegisterAssignment proj6::assignRegisters(
+    const GraphSnapshot<Variable> &snapshot, int num_registers) noexcept {
+  return colorGraph(snapshot, num_registers, snapshot.getMaxDegree());
+}
+
+// Greedy coloring followed by the local-search pass from LocalSearch.hpp,
+// which only ever lowers the number of registers used.
+RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
+                                          int num_registers,
+                                          const SearchBudget &budget) noexcept {
+  return assignRegisters(path_to_graph, num_registers, Engine::LocalSearch,
+                         budget);
+}
+
+RegisterAssignment proj6::assignRegisters(
+    const std::string &path_to_graph, int num_registers,
+    const RegisterConstraints &constraints) noexcept {
+  if (num_registers < 1 || num_registers > MAX_CONSTRAINED_REGISTERS) {
+    return {};
+  }
+  const IndexedGraph graph(CSVReader::loadPipelined(path_to_graph));
+  return colorGraphConstrained(graph, num_registers, constraints);
+}
+
+RegisterAssignment proj6::assignRegisters(const std::string &path_to_graph,
+                                          int num_registers, Engine engine,
+                                          const SearchBudget &budget) noexcept {
+  const InterferenceGraph<Variable> ig =
+      CSVReader::loadPipelined(path_to_graph);
+
+  switch (engine) {
+    case Engine::LocalSearch: {
+      const RegisterAssignment assignment =
+          colorGraph(ig, num_registers, ig.getMaxDegree());
+      if (assignment.empty()) {
+        return assignment;
+      }
+      return improveAssignment(ig, assignment, budget);
+    }
+
+    case Engine::Exact: {
+      // Unlike Welsh-Powell this can succeed with fewer than d(G) + 1
+      // registers, since it knows the real minimum. The search revisits
+      // neighbor lists at every node, so renumber them to sit together.
+      const IndexedGraph indexed(ig);
+      const IndexedGraph graph = indexed.relabeled(
+          vertexOrder(indexed, VertexOrder::ReverseCuthillMcKee));
+      const ExactResult result = exactColoring(graph, budget);
+      if (result.numRegisters > num_registers) {
+        return {};
+      }
+      return graph.toAssignment(result.colors);
+    }
+
+    case Engine::Auto: {
+      const IndexedGraph graph(ig);
+      const ClassColoring result = colorByClass(graph);
+      if (result.numRegisters > num_registers) {
+        return {};
+      }
+      return graph.toAssignment(result.colors);
+    }
+
+    case Engine::WelshPowell:
+    default:
+      return colorGraph(ig, num_registers, ig.getMaxDegree());
+  }
+}
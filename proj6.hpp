@@ -1,18 +1,106 @@
 #ifndef __PROJ_6__HPP
 #define __PROJ_6__HPP
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
+template <typename T>
+class GraphSnapshot;
+
+template <typename T>
+class InterferenceGraph;
+
 namespace proj6 {
 
 using Variable = std::string;
 using Register = int;
 using RegisterAssignment = std::unordered_map<Variable, Register>;
 
+// Live range of a variable over instruction indices [start, end). Used by
+// the linear-scan engine in LinearScan.hpp.
+struct LiveInterval {
+  Variable var;
+  unsigned start;
+  unsigned end;
+};
+
+// Bit r - 1 is set if register r may be used. Masks can only describe
+// registers 1 through MAX_CONSTRAINED_REGISTERS.
+using RegisterMask = std::uint64_t;
+const int MAX_CONSTRAINED_REGISTERS = 64;
+
+// Fixed registers (call arguments, return values, ...) and register
+// classes for the constrained assignRegisters overload. Variables missing
+// from `allowed` may use any register.
+struct RegisterConstraints {
+  RegisterAssignment precolored;
+  std::unordered_map<Variable, RegisterMask> allowed;
+};
+
+// Coloring engines selectable through assignRegisters.
+enum class Engine {
+  // Welsh-Powell greedy coloring (the default).
+  WelshPowell,
+
+  // Welsh-Powell followed by the improvement pass in LocalSearch.hpp.
+  LocalSearch,
+
+  // Branch and bound minimum coloring for small graphs, see
+  // ExactColoring.hpp.
+  Exact,
+
+  // Classify the graph (edgeless, complete, forest, bipartite, small max
+  // degree) and use that class's linear-time colorer, falling back to
+  // greedy coloring. See GraphClass.hpp. Like Exact, this can succeed
+  // with fewer than d(G) + 1 registers.
+  Auto,
+};
+
+// Limits for the search-based engines. A zero field means that field is
+// unlimited. For LocalSearch, if both are zero the pass does nothing; for
+// Exact, `iterations` counts branch-and-bound nodes.
+struct SearchBudget {
+  std::chrono::microseconds time{5000};
+  unsigned long iterations = 0;
+};
+
 RegisterAssignment assignRegisters(const std::string &path_to_graph,
                                    int num_registers) noexcept;
 
+// Same as above on a graph that is already loaded, so the caller can
+// reuse it (to write it out with IGWriter, say) without parsing the file
+// again. To try several register counts see AllocatorContext.hpp.
+RegisterAssignment assignRegisters(const InterferenceGraph<Variable> &ig,
+                                   int num_registers) noexcept;
+
+// Same as above on a snapshot of a VersionedInterferenceGraph, so the
+// graph can keep being edited while this runs.
+RegisterAssignment assignRegisters(const GraphSnapshot<Variable> &snapshot,
+                                   int num_registers) noexcept;
+
+// Same as the first overload, then spends at most `budget` trying to
+// reduce the number of registers used. See LocalSearch.hpp.
+RegisterAssignment assignRegisters(const std::string &path_to_graph,
+                                   int num_registers,
+                                   const SearchBudget &budget) noexcept;
+
+// Welsh-Powell coloring that honors `constraints`. Precolored variables
+// keep their register and every other variable gets the lowest register
+// allowed by its mask that no neighbor holds. Returns an empty map if that
+// fails, if a precolored register is out of range or not allowed, or if
+// num_registers is above MAX_CONSTRAINED_REGISTERS.
+RegisterAssignment assignRegisters(
+    const std::string &path_to_graph, int num_registers,
+    const RegisterConstraints &constraints) noexcept;
+
+// Color with the given engine. Like the other overloads, an empty map is
+// returned if the engine's coloring needs more than num_registers.
+RegisterAssignment assignRegisters(const std::string &path_to_graph,
+                                   int num_registers, Engine engine,
+                                   const SearchBudget &budget = {}) noexcept;
+
 };  // namespace proj6
 
-#endif
\ No newline at end of file
+#endif
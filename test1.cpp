@@ -1,10 +1,49 @@
+#include "AllocationClient.hpp"
+#include "AllocationServer.hpp"
+#include "AllocatorContext.hpp"
+#include "AssignmentCache.hpp"
 #include "CSVReader.hpp"
+#include "Coalescing.hpp"
+#include "CompressedGraph.hpp"
+#include "ConcurrentGraphBuilder.hpp"
+#include "ExactColoring.hpp"
+#include "FlatHashMap.hpp"
+#include "GraphClass.hpp"
+#include "GraphQueries.hpp"
+#include "GreedyColoring.hpp"
 #include "IGWriter.hpp"
+#include "IndexedGraph.hpp"
+#include "InputFile.hpp"
 #include "InterferenceGraph.hpp"
+#include "LinearScan.hpp"
+#include "LocalSearch.hpp"
+#include "SpillLoop.hpp"
+#include "VersionedInterferenceGraph.hpp"
+#include "VertexOrder.hpp"
+#include "WordLadder.hpp"
 #include "gtest/gtest.h"
 #include "proj6.hpp"
 #include "verifier.hpp"
 
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 // Warning: These are *NOT* exhaustive tests.
 // You should consider creating your own unit tests
 // to test the functionality of your code entirely.
@@ -58,4 +97,1167 @@ TEST(RequiredPart2, SimpleFail) {
   EXPECT_TRUE(allocation.empty());
 }
 
+TEST(LocalSearch, FreesRegistersFromWastefulAssignment) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+
+  const InterferenceGraph<Variable> &ig = CSVReader::load(GRAPH);
+
+  // Every variable in its own register is valid but uses 6 registers.
+  RegisterAssignment wasteful;
+  Register next = 1;
+  for (const auto &v : ig.vertices()) wasteful[v] = next++;
+
+  SearchBudget budget;
+  budget.iterations = 100000;
+  const auto &improved = improveAssignment(ig, wasteful, budget);
+
+  std::unordered_set<Register> used;
+  for (const auto &e : improved) used.insert(e.second);
+
+  EXPECT_EQ(used.size(), 2);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, improved));
+}
+
+TEST(LocalSearch, AssignRegistersWithBudget) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+  const auto NUM_REGS = 3;
+
+  const auto &allocation = assignRegisters(GRAPH, NUM_REGS, SearchBudget{});
+
+  EXPECT_TRUE(verifyAllocation(GRAPH, NUM_REGS, allocation));
+  EXPECT_TRUE(assignRegisters(GRAPH, 2, SearchBudget{}).empty());
+}
+
+TEST(ExactColoring, BipartiteNeedsTwoRegisters) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+
+  // Welsh-Powell gives up here since d(G) + 1 = 5, but two registers are
+  // enough for a bipartite graph.
+  EXPECT_TRUE(assignRegisters(GRAPH, 2).empty());
+
+  const auto &allocation = assignRegisters(GRAPH, 2, Engine::Exact);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 2, allocation));
+  EXPECT_TRUE(assignRegisters(GRAPH, 1, Engine::Exact).empty());
+}
+
+TEST(ExactColoring, CompleteGraphIsOptimal) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+
+  const IndexedGraph graph(CSVReader::load(GRAPH));
+  const auto &result = exactColoring(graph, SearchBudget{});
+
+  EXPECT_TRUE(result.optimal);
+  EXPECT_EQ(result.numRegisters, 6);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, graph.toAssignment(result.colors)));
+}
+
+TEST(RegisterConstraints, PrecoloredAndMasks) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+  const auto NUM_REGS = 3;
+
+  RegisterConstraints constraints;
+  constraints.precolored["x"] = 3;
+  constraints.allowed["z"] = 0b010;  // register 2 only
+
+  const auto &allocation = assignRegisters(GRAPH, NUM_REGS, constraints);
+
+  EXPECT_TRUE(verifyAllocation(GRAPH, NUM_REGS, allocation));
+  EXPECT_EQ(allocation.at("x"), 3);
+  EXPECT_EQ(allocation.at("z"), 2);
+  EXPECT_EQ(allocation.at("y"), 1);
+}
+
+TEST(RegisterConstraints, UnsatisfiableConstraintsFail) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+
+  RegisterConstraints clash;
+  clash.precolored["x"] = 1;
+  clash.precolored["y"] = 1;
+  EXPECT_TRUE(assignRegisters(GRAPH, 3, clash).empty());
+
+  RegisterConstraints tooNarrow;
+  tooNarrow.allowed["x"] = 0b001;
+  tooNarrow.allowed["y"] = 0b001;
+  EXPECT_TRUE(assignRegisters(GRAPH, 3, tooNarrow).empty());
+}
+
+TEST(LinearScan, IntervalsFromFile) {
+  const auto &INTERVALS = "gtest/graphs/intervals.csv";
+
+  const auto &intervals = CSVReader::loadIntervals(INTERVALS);
+  const InterferenceGraph<Variable> &ig = buildInterferenceGraph(intervals);
+
+  // a, b and c are all live at position 2.
+  EXPECT_EQ(ig.numVertices(), 5);
+  EXPECT_EQ(ig.numEdges(), 5);
+  EXPECT_TRUE(assignRegistersFromIntervals(INTERVALS, 2).empty());
+
+  const auto &allocation = assignRegistersFromIntervals(INTERVALS, 3);
+  ASSERT_EQ(allocation.size(), 5);
+  for (const auto &v : ig.vertices()) {
+    for (const auto &w : ig.neighbors(v)) {
+      EXPECT_NE(allocation.at(v), allocation.at(w));
+    }
+  }
+}
+
+TEST(PipelinedLoad, MatchesLoad) {
+  for (const auto &GRAPH :
+       {"gtest/graphs/simple.csv", "gtest/graphs/complete_6.csv",
+        "gtest/graphs/big_bipartite.csv"}) {
+    const InterferenceGraph<Variable> &expected = CSVReader::load(GRAPH);
+    const InterferenceGraph<Variable> &ig = CSVReader::loadPipelined(GRAPH);
+
+    EXPECT_EQ(ig.numVertices(), expected.numVertices());
+    EXPECT_EQ(ig.numEdges(), expected.numEdges());
+    EXPECT_EQ(ig.getMaxDegree(), expected.getMaxDegree());
+    for (const auto &v : expected.vertices()) {
+      EXPECT_EQ(ig.neighbors(v), expected.neighbors(v));
+    }
+  }
+}
+
+TEST(PipelinedLoad, RowsSpanningBlocks) {
+  // Long names so that many rows straddle the reader's block boundaries.
+  const auto &GRAPH = "gtest/graphs/pipelined_chain.csv";
+  {
+    std::ofstream out(GRAPH);
+    const std::string prefix(100, 'v');
+    for (int i = 0; i < 5000; i++) {
+      out << prefix << i << "," << prefix << i + 1 << "\n";
+    }
+  }
+
+  const InterferenceGraph<Variable> &ig = CSVReader::loadPipelined(GRAPH);
+  EXPECT_EQ(ig.numVertices(), 5001);
+  EXPECT_EQ(ig.numEdges(), 5000);
+  const std::string &name = std::string(100, 'v') + "2500";
+  EXPECT_EQ(ig.neighbors(name).size(), 2);
+}
+
+TEST(PipelinedLoad, BadRowsInSmallAndLargeFiles) {
+  // Under one block the file is read without a reader thread; the last
+  // line has no newline.
+  const auto &SMALL = "gtest/graphs/pipelined_small.csv";
+  std::ofstream(SMALL) << "a,b\nb,c\nc";
+  const InterferenceGraph<Variable> &ig = CSVReader::loadPipelined(SMALL);
+  EXPECT_EQ(ig.numVertices(), 3);
+  EXPECT_EQ(ig.numEdges(), 2);
+
+  const auto &SMALL_BAD = "gtest/graphs/pipelined_small_bad.csv";
+  std::ofstream(SMALL_BAD) << "a,b\na,b,c\n";
+  EXPECT_THROW(CSVReader::loadPipelined(SMALL_BAD), std::runtime_error);
+
+  // A bad row early in a large file still drains and joins the reader.
+  const auto &LARGE_BAD = "gtest/graphs/pipelined_large_bad.csv";
+  {
+    std::ofstream out(LARGE_BAD);
+    out << "a,b,c\n";
+    for (int i = 0; i < 100000; i++) {
+      out << "v" << i << ",v" << i + 1 << "\n";
+    }
+  }
+  EXPECT_THROW(CSVReader::loadPipelined(LARGE_BAD), std::runtime_error);
+}
+
+TEST(AssignmentCache, HitReturnsStoredAssignment) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+  const auto &REORDERED = "gtest/graphs/simple_reordered.csv";
+  {
+    std::ofstream out(REORDERED);
+    out << "y,z\ny,x\nx,z\n";
+  }
+
+  // Keys follow the bytes of the file, not the graph it describes.
+  const auto &key = AssignmentCache::keyFor(GRAPH, 3, Engine::WelshPowell);
+  EXPECT_EQ(AssignmentCache::keyFor(GRAPH, 3, Engine::WelshPowell).hex(),
+            key.hex());
+  EXPECT_NE(AssignmentCache::keyFor(REORDERED, 3, Engine::WelshPowell).hex(),
+            key.hex());
+  EXPECT_NE(AssignmentCache::keyFor(GRAPH, 4, Engine::WelshPowell).hex(),
+            key.hex());
+  EXPECT_NE(AssignmentCache::keyFor(GRAPH, 3, Engine::Exact).hex(),
+            key.hex());
+
+  // Only the search engines' keys depend on the budget.
+  SearchBudget longer;
+  longer.iterations = 1000;
+  EXPECT_EQ(
+      AssignmentCache::keyFor(GRAPH, 3, Engine::WelshPowell, longer).hex(),
+      key.hex());
+  EXPECT_NE(AssignmentCache::keyFor(GRAPH, 3, Engine::Exact, longer).hex(),
+            AssignmentCache::keyFor(GRAPH, 3, Engine::Exact).hex());
+
+  AssignmentCache cache("gtest/cache");
+  const RegisterAssignment stored = {{"x", 3}, {"y", 1}, {"z", 2}};
+  cache.store(key, stored);
+
+  RegisterAssignment found;
+  EXPECT_TRUE(cache.lookup(key, found));
+  EXPECT_EQ(found, stored);
+
+  // A hit skips allocation, so the stored answer comes back unchanged.
+  EXPECT_EQ(assignRegisters(GRAPH, 3, Engine::WelshPowell, {}, cache),
+            stored);
+}
+
+TEST(AssignmentCache, EvictsWhenFull) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+
+  // Room for roughly one entry.
+  AssignmentCache cache("gtest/cache_small", 64);
+  const auto &first =
+      assignRegisters(GRAPH, 6, Engine::WelshPowell, {}, cache);
+  assignRegisters(GRAPH, 7, Engine::WelshPowell, {}, cache);
+
+  RegisterAssignment found;
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, first));
+  EXPECT_FALSE(cache.lookup(
+      AssignmentCache::keyFor(GRAPH, 6, Engine::WelshPowell), found));
+  EXPECT_TRUE(cache.lookup(
+      AssignmentCache::keyFor(GRAPH, 7, Engine::WelshPowell), found));
+
+  // A missing file is a failed allocation, not an exception.
+  EXPECT_TRUE(assignRegisters("gtest/graphs/missing.csv", 6,
+                              Engine::WelshPowell, {}, cache)
+                  .empty());
+}
+
+TEST(AssignmentCache, ConcurrentStoresOfOneKey) {
+  // Writers of the same key, each with its own cache object as separate
+  // processes would have, never publish a mix of two entries.
+  const CacheKey key = AssignmentCache::contentKey("concurrent");
+  RegisterAssignment small = {{"a", 1}};
+  RegisterAssignment large;
+  for (int i = 0; i < 2000; i++) {
+    large["variable" + std::to_string(i)] = i % 7 + 1;
+  }
+
+  std::atomic<bool> torn{false};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; t++) {
+    writers.emplace_back([&, t] {
+      AssignmentCache cache("gtest/cache_concurrent");
+      RegisterAssignment found;
+      for (int i = 0; i < 100; i++) {
+        cache.store(key, (i + t) % 2 ? small : large);
+        // Once any store has finished a whole entry is in place, so a
+        // miss here means a reader saw a half-written file.
+        if (!cache.lookup(key, found) || (found != small && found != large)) {
+          torn = true;
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  EXPECT_FALSE(torn);
+
+  RegisterAssignment found;
+  EXPECT_TRUE(AssignmentCache("gtest/cache_concurrent").lookup(key, found));
+}
+
+TEST(MemoryUsage, CompactGraphMatchesAndIsSmaller) {
+  for (const auto &GRAPH :
+       {"gtest/graphs/simple.csv", "gtest/graphs/complete_6.csv",
+        "gtest/graphs/big_bipartite.csv"}) {
+    const InterferenceGraph<Variable> &ig = CSVReader::load(GRAPH);
+    const CompactInterferenceGraph<Variable> &compact =
+        CSVReader::loadCompact(GRAPH);
+
+    EXPECT_EQ(compact.numVertices(), ig.numVertices());
+    EXPECT_EQ(compact.numEdges(), ig.numEdges());
+    EXPECT_EQ(compact.getMaxDegree(), ig.getMaxDegree());
+    for (const auto &v : ig.vertices()) {
+      EXPECT_EQ(compact.neighbors(v), ig.neighbors(v));
+    }
+
+    const auto &usage = ig.memoryUsage();
+    EXPECT_GT(usage.names, 0);
+    EXPECT_GT(usage.adjacency, 0);
+    EXPECT_GT(usage.hashOverhead, 0);
+    EXPECT_LT(compact.memoryUsage().total(), usage.total());
+  }
+}
+
+TEST(MemoryUsage, CompactGraphMutation) {
+  CompactInterferenceGraph<Variable> ig;
+  ig.addEdge("a", "b");
+  ig.addEdge("b", "c");
+  ig.addEdge("c", "d");
+  ig.addEdge("d", "a");
+  ig.addEdge("a", "c");
+
+  ig.removeVertex("a");
+  EXPECT_EQ(ig.numVertices(), 3);
+  EXPECT_EQ(ig.numEdges(), 2);
+  EXPECT_TRUE(ig.interferes("d", "c"));
+  EXPECT_FALSE(ig.interferes("b", "d"));
+  EXPECT_THROW(ig.degree("a"), UnknownVertexException);
+
+  ig.removeEdge("b", "c");
+  EXPECT_EQ(ig.numEdges(), 1);
+  EXPECT_EQ(ig.degree("b"), 0);
+  EXPECT_EQ(ig.getVerticesSortedByDegree().back(), "b");
+}
+
+TEST(ConcurrentGraphBuilder, ManyThreadsMatchSerialLoad) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+  const InterferenceGraph<Variable> &expected = CSVReader::load(GRAPH);
+
+  ConcurrentGraphBuilder<Variable> builder(4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    // Every thread adds every edge, in a different direction per thread.
+    threads.emplace_back([&builder, t]() {
+      for (int i = 1; i <= 6; i++) {
+        for (int j = i + 1; j <= 6; j++) {
+          if (t % 2 == 0) {
+            builder.addEdge(std::to_string(i), std::to_string(j));
+          } else {
+            builder.addEdge(std::to_string(j), std::to_string(i));
+          }
+        }
+      }
+      builder.addVertex("lonely");
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const InterferenceGraph<Variable> &ig = builder.build();
+  EXPECT_EQ(ig.numVertices(), expected.numVertices() + 1);
+  EXPECT_EQ(ig.numEdges(), expected.numEdges());
+  for (const auto &v : expected.vertices()) {
+    EXPECT_EQ(ig.neighbors(v), expected.neighbors(v));
+  }
+  EXPECT_EQ(ig.degree("lonely"), 0);
+}
+
+TEST(GraphSnapshot, ReadersSeeConsistentVersion) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+
+  VersionedInterferenceGraph<Variable> graph(CSVReader::load(GRAPH));
+  const auto &before = graph.snapshot();
+
+  // Edit the graph after the snapshot was taken.
+  for (const auto &v : {"x", "y", "z"}) graph.addEdge("w", v);
+  graph.removeEdge("x", "y");
+
+  EXPECT_EQ(before.numVertices(), 3);
+  EXPECT_EQ(before.numEdges(), 3);
+  EXPECT_TRUE(before.interferes("x", "y"));
+  EXPECT_EQ(graph.numVertices(), 4);
+  EXPECT_EQ(graph.numEdges(), 5);
+  EXPECT_FALSE(graph.interferes("x", "y"));
+  EXPECT_GT(graph.version(), before.version());
+
+  const auto &allocation = assignRegisters(before, 3);
+  IGWriter::write(before, "gtest/graphs/simple_snapshot.dot", allocation);
+  EXPECT_TRUE(verifyAllocation(before, 3, allocation));
+  EXPECT_TRUE(verifyAllocation(GRAPH, 3, allocation));
+
+  const auto &after = graph.snapshot();
+  EXPECT_TRUE(verifyAllocation(after, 4, assignRegisters(after, 4)));
+}
+
+TEST(CompressedGraph, SameNeighborsAndColoring) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  const IndexedGraph graph(CSVReader::load(GRAPH));
+  const CompressedGraph compressed(graph);
+
+  ASSERT_EQ(compressed.size(), graph.size());
+  EXPECT_EQ(compressed.numEdges(), graph.numEdges());
+  for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+    std::vector<IndexedGraph::Id> row;
+    compressed.forEachNeighbor(
+        v, [&row](IndexedGraph::Id w) { row.push_back(w); });
+    EXPECT_EQ(row, std::vector<IndexedGraph::Id>(graph.neighborsBegin(v),
+                                                 graph.neighborsEnd(v)));
+    EXPECT_EQ(compressed.degree(v), graph.degree(v));
+  }
+
+  const auto &colors = largestFirstColoring(compressed);
+  EXPECT_EQ(colors, largestFirstColoring(graph));
+  const auto &allocation = compressed.toAssignment(colors);
+  EXPECT_TRUE(verifyAllocation(GRAPH, graph.size(), allocation));
+}
+
+TEST(CompressedGraph, SmallerThanCsr) {
+  InterferenceGraph<Variable> ig;
+  for (int i = 1; i < 2000; i++) {
+    ig.addEdge("v" + std::to_string(i - 1), "v" + std::to_string(i));
+  }
+  const IndexedGraph graph(ig);
+  const CompressedGraph compressed(graph);
+
+  // IndexedGraph spends 4 bytes per offset and per neighbor entry.
+  const std::size_t csrBytes = 4 * (graph.size() + 1 + 2 * graph.numEdges());
+  EXPECT_EQ(compressed.numEdges(), 1999);
+  EXPECT_LT(compressed.memoryUsage().adjacency, csrBytes);
+
+  const auto &colors = largestFirstColoring(compressed);
+  for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+    compressed.forEachNeighbor(v, [&colors, v](IndexedGraph::Id w) {
+      EXPECT_NE(colors[v], colors[w]);
+    });
+  }
+}
+
+TEST(CompressedGraph, StreamingLoadMatchesGraph) {
+  const auto &MESSY = "gtest/graphs/compressed_messy.csv";
+  std::ofstream(MESSY) << "a,b\nb,a\nc\nc,c\nb,d\nd,e\ne,b\na,b\nf,a\n";
+
+  // Tiny chunks force many runs, with duplicates spread across them.
+  for (const auto &GRAPH : {MESSY, "gtest/graphs/complete_6.csv",
+                            "gtest/graphs/big_bipartite.csv"}) {
+    const InterferenceGraph<Variable> &ig = CSVReader::load(GRAPH);
+    for (const std::size_t chunk : {std::size_t(2), std::size_t(5),
+                                    std::size_t(1) << 20}) {
+      const CompressedGraph &compressed = CompressedGraph::load(GRAPH, chunk);
+      ASSERT_EQ(compressed.size(), ig.numVertices());
+      EXPECT_EQ(compressed.numEdges(), IndexedGraph(ig).numEdges());
+      for (IndexedGraph::Id v = 0; v < compressed.size(); v++) {
+        std::unordered_set<Variable> row;
+        compressed.forEachNeighbor(v, [&](IndexedGraph::Id w) {
+          row.insert(compressed.name(w));
+        });
+        EXPECT_EQ(row, ig.getNeighbors(compressed.name(v)));
+        EXPECT_EQ(compressed.degree(v), row.size());
+      }
+    }
+  }
+
+  // The class dispatcher runs on the compressed form directly.
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  const CompressedGraph &compressed = CompressedGraph::load(GRAPH);
+  const ClassColoring &result = colorByClass(compressed);
+  EXPECT_EQ(result.graphClass, GraphClass::Bipartite);
+  EXPECT_TRUE(
+      verifyAllocation(GRAPH, 2, compressed.toAssignment(result.colors)));
+  EXPECT_EQ(classifyGraph(CompressedGraph::load("gtest/graphs/complete_6.csv")),
+            GraphClass::Complete);
+}
+
+TEST(VertexOrder, RelabeledGraphMapsBackToNames) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  const IndexedGraph graph(CSVReader::load(GRAPH));
+
+  for (const auto order :
+       {VertexOrder::Original, VertexOrder::DegreeDescending,
+        VertexOrder::BreadthFirst, VertexOrder::ReverseCuthillMcKee}) {
+    auto permutation = vertexOrder(graph, order);
+    const IndexedGraph &relabeled = graph.relabeled(permutation);
+    std::sort(permutation.begin(), permutation.end());
+    for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+      EXPECT_EQ(permutation[v], v);
+      EXPECT_EQ(relabeled.name(relabeled.id(graph.name(v))), graph.name(v));
+      EXPECT_EQ(relabeled.degree(relabeled.id(graph.name(v))),
+                graph.degree(v));
+    }
+
+    const CompressedGraph compressed(graph, order);
+    const auto &allocation =
+        compressed.toAssignment(largestFirstColoring(compressed));
+    EXPECT_TRUE(verifyAllocation(GRAPH, 2, allocation));
+  }
+}
+
+TEST(VertexOrder, CuthillMcKeeShrinksCompressedGraph) {
+  InterferenceGraph<Variable> ig;
+  for (int i = 1; i < 2000; i++) {
+    ig.addEdge("v" + std::to_string(i - 1), "v" + std::to_string(i));
+  }
+  const IndexedGraph graph(ig);
+
+  // On a path, RCM puts every vertex next to its neighbors, so each row
+  // is at most three single bytes.
+  const CompressedGraph hashed(graph);
+  const CompressedGraph local(graph, VertexOrder::ReverseCuthillMcKee);
+  EXPECT_LT(local.memoryUsage().adjacency, hashed.memoryUsage().adjacency);
+  EXPECT_LE(local.memoryUsage().adjacency,
+            (graph.size() + 1) * sizeof(unsigned) + 3 * graph.size());
+}
+
+TEST(VertexOrder, AllocatorContextColorsTheRelabeledGraph) {
+  InterferenceGraph<Variable> ig;
+  for (int i = 1; i < 2000; i++) {
+    ig.addEdge("v" + std::to_string(i - 1), "v" + std::to_string(i));
+  }
+  const auto &bandwidth = [](const IndexedGraph &graph) {
+    IndexedGraph::Id widest = 0;
+    for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+      graph.forEachNeighbor(v, [&widest, v](IndexedGraph::Id w) {
+        widest = std::max(widest, v > w ? v - w : w - v);
+      });
+    }
+    return widest;
+  };
+
+  // The context renumbers the path so neighbors are adjacent ids, and its
+  // assignments still name the original variables.
+  AllocatorContext context(ig);
+  AllocatorContext hashed(ig, VertexOrder::Original);
+  EXPECT_EQ(bandwidth(context.graph()), 1);
+  EXPECT_GT(bandwidth(hashed.graph()), 1);
+  for (const auto engine :
+       {Engine::WelshPowell, Engine::LocalSearch, Engine::Auto}) {
+    const auto &allocation = context.assignRegisters(3, engine);
+    ASSERT_EQ(allocation.size(), ig.numVertices());
+    for (const auto &v : ig.vertices()) {
+      EXPECT_LE(allocation.at(v), 3);
+      for (const auto &w : ig.neighbors(v)) {
+        EXPECT_NE(allocation.at(v), allocation.at(w));
+      }
+    }
+  }
+}
+
+TEST(DegreeIndex, TracksEditsAndCopies) {
+  InterferenceGraph<Variable> ig;
+  ig.addEdge("a", "b");
+  ig.addEdge("a", "c");
+  ig.addEdge("a", "d");
+  ig.addEdge("b", "c");
+  ig.addEdge("b", "a");
+  ig.addVertex("e");
+  EXPECT_EQ(ig.numEdges(), 4);
+  EXPECT_EQ(ig.getMaxDegree(), 3);
+  EXPECT_EQ(ig.getVerticesSortedByDegree().front(), "a");
+  EXPECT_EQ(ig.getVerticesSortedByDegree().back(), "e");
+
+  InterferenceGraph<Variable> copy = ig;
+  ig.removeVertex("a");
+  EXPECT_EQ(ig.numEdges(), 1);
+  EXPECT_EQ(ig.getMaxDegree(), 1);
+  ig.removeEdge("b", "c");
+  EXPECT_EQ(ig.numEdges(), 0);
+  EXPECT_EQ(ig.getMaxDegree(), 0);
+  EXPECT_EQ(ig.getVerticesSortedByDegree().size(), 4);
+
+  // The copy keeps its own index.
+  EXPECT_EQ(copy.numEdges(), 4);
+  EXPECT_EQ(copy.getMaxDegree(), 3);
+  copy.removeEdge("a", "d");
+  EXPECT_EQ(copy.getMaxDegree(), 2);
+  const auto &order = copy.getVerticesSortedByDegree();
+  for (std::size_t i = 1; i < order.size(); i++) {
+    EXPECT_GE(copy.degree(order[i - 1]), copy.degree(order[i]));
+  }
+
+  // A moved-from graph is empty and can be used again.
+  InterferenceGraph<Variable> moved(std::move(copy));
+  EXPECT_EQ(moved.getMaxDegree(), 2);
+  EXPECT_EQ(copy.numVertices(), 0);
+  EXPECT_EQ(copy.numEdges(), 0);
+  copy.addEdge("p", "q");
+  EXPECT_EQ(copy.getMaxDegree(), 1);
+  moved = std::move(copy);
+  EXPECT_EQ(moved.numEdges(), 1);
+  copy.addEdge("r", "s");
+  EXPECT_EQ(copy.numEdges(), 1);
+}
+
+TEST(GraphQueries, CompleteGraph) {
+  const IndexedGraph graph(CSVReader::load("gtest/graphs/complete_6.csv"));
+  const auto v = graph.id("1");
+  const auto w = graph.id("2");
+
+  const auto &common = commonNeighbors(graph, v, w);
+  EXPECT_EQ(common.size(), 4);
+  EXPECT_TRUE(std::is_sorted(common.begin(), common.end()));
+  EXPECT_EQ(countCommonNeighbors(graph, v, w), 4);
+
+  const auto &answers = interferesMany(graph, v, {w, v, w, graph.id("6")});
+  EXPECT_EQ(answers, std::vector<bool>({true, false, true, true}));
+
+  EXPECT_EQ(countTriangles(graph), 20);
+  EXPECT_EQ(countCliques(graph, 2), 15);
+  EXPECT_EQ(countCliques(graph, 4), 15);
+  EXPECT_EQ(countCliques(graph, 6), 1);
+  EXPECT_EQ(countCliques(graph, 7), 0);
+}
+
+TEST(GraphQueries, BipartiteHasNoTriangles) {
+  const IndexedGraph graph(CSVReader::load("gtest/graphs/big_bipartite.csv"));
+  EXPECT_EQ(countTriangles(graph), 0);
+  EXPECT_EQ(countCliques(graph, 2), graph.numEdges());
+  for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+    const std::vector<IndexedGraph::Id> row(graph.neighborsBegin(v),
+                                            graph.neighborsEnd(v));
+    for (const auto w : row) {
+      EXPECT_TRUE(commonNeighbors(graph, v, w).empty());
+    }
+    const auto &answers = interferesMany(graph, v, row);
+    EXPECT_EQ(std::count(answers.begin(), answers.end(), true), row.size());
+  }
+}
+
+TEST(WordLadder, ShortestLadderInEveryMode) {
+  const WordDictionary dictionary(
+      {"hot", "dot", "dog", "lot", "log", "cog", "hog", "cot"});
+  // "hit" is not in the dictionary; only the words after it have to be.
+  TraversalOptions parallel;
+  parallel.threads = 4;
+  parallel.parallelThreshold = 1;
+  TraversalOptions oneSided;
+  oneSided.bidirectional = false;
+
+  for (const auto &options : {TraversalOptions(), parallel, oneSided}) {
+    const auto &ladder = wordLadder(dictionary, "hit", "cog", options);
+    ASSERT_EQ(ladder.size(), 4);
+    EXPECT_EQ(ladder.front(), "hit");
+    EXPECT_EQ(ladder.back(), "cog");
+    for (std::size_t i = 1; i < ladder.size(); i++) {
+      EXPECT_TRUE(dictionary.contains(ladder[i]));
+      int differences = 0;
+      for (std::size_t c = 0; c < 3; c++) {
+        differences += ladder[i - 1][c] != ladder[i][c];
+      }
+      EXPECT_EQ(differences, 1);
+    }
+  }
+}
+
+TEST(WordLadder, UnreachableAndTrivial) {
+  const WordDictionary dictionary({"cold", "cord", "card", "ward", "warm"});
+  EXPECT_EQ(wordLadder(dictionary, "cold", "warm").size(), 5);
+  EXPECT_TRUE(wordLadder(dictionary, "cold", "wars").empty());
+  EXPECT_TRUE(wordLadder(dictionary, "cold", "cat").empty());
+  EXPECT_EQ(wordLadder(dictionary, "card", "card"),
+            std::vector<std::string>({"card"}));
+
+  // Copies own their pattern index and outlive the original.
+  auto original = std::make_unique<WordDictionary>(
+      std::vector<std::string>({"cold", "cord", "card"}));
+  WordDictionary copy(*original);
+  WordDictionary assigned({"x"});
+  assigned = *original;
+  original.reset();
+  EXPECT_EQ(wordLadder(copy, "cold", "card").size(), 3);
+  EXPECT_EQ(wordLadder(assigned, "cold", "card").size(), 3);
+  const WordDictionary moved(std::move(copy));
+  EXPECT_EQ(wordLadder(moved, "cold", "card").size(), 3);
+  EXPECT_EQ(copy.size(), 0);
+
+  // A generic implicit graph: integers, neighbors n - 1 and n + 1.
+  const auto &path = shortestPath(0, 5, [](int n, auto emit) {
+    emit(n - 1);
+    emit(n + 1);
+  });
+  EXPECT_EQ(path, std::vector<int>({0, 1, 2, 3, 4, 5}));
+}
+
+TEST(SpillLoop, SpillsUntilColorable) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+  InterferenceGraph<Variable> ig = CSVReader::load(GRAPH);
+
+  const auto &result = allocateWithSpills(ig, 4);
+  EXPECT_EQ(result.spilled.size(), 2);
+  EXPECT_EQ(ig.numVertices(), 4);
+  ASSERT_EQ(result.assignment.size(), 4);
+  for (const auto &v : ig.vertices()) {
+    EXPECT_LE(result.assignment.at(v), 4);
+    for (const auto &w : ig.neighbors(v)) {
+      EXPECT_NE(result.assignment.at(v), result.assignment.at(w));
+    }
+  }
+}
+
+TEST(SpillLoop, SplitsLiveRanges) {
+  const auto &intervals =
+      CSVReader::loadIntervals("gtest/graphs/intervals.csv");
+
+  // Three intervals overlap at position 2, so two registers need a split.
+  const auto &result = allocateWithSpills(intervals, 2);
+  EXPECT_GT(result.rounds, 1);
+  ASSERT_EQ(result.assignment.size(), result.intervals.size());
+  for (const auto &a : result.intervals) {
+    EXPECT_LE(result.assignment.at(a.var), 2);
+    for (const auto &b : result.intervals) {
+      if (a.var != b.var && a.start < b.end && b.start < a.end) {
+        EXPECT_NE(result.assignment.at(a.var), result.assignment.at(b.var));
+      }
+    }
+  }
+
+  // Nothing to do with enough registers.
+  const auto &easy = allocateWithSpills(intervals, 3);
+  EXPECT_EQ(easy.rounds, 1);
+  EXPECT_TRUE(easy.spilled.empty());
+  EXPECT_EQ(easy.intervals.size(), 5);
+}
+
+TEST(SpillLoop, SplitPiecesNeverReuseNames) {
+  // With one register all but one variable splits, and every split of x,
+  // "x#1" or "x#2" would name a piece after a variable that already exists.
+  std::vector<LiveInterval> intervals;
+  for (const auto &var :
+       {"x", "x#1", "x#2", "x#1#1", "x#1#2", "x#2#1", "x#2#2"}) {
+    intervals.push_back({var, 0, 8});
+  }
+
+  const auto &result = allocateWithSpills(intervals, 1);
+  std::unordered_set<Variable> names;
+  for (const auto &interval : result.intervals) {
+    EXPECT_TRUE(names.insert(interval.var).second) << interval.var;
+  }
+  for (const auto &var : result.spilled) {
+    EXPECT_TRUE(names.insert(var).second) << var;
+  }
+
+  // Every position of every variable is either assigned or spilled.
+  unsigned covered = 0;
+  for (const auto &interval : result.intervals) {
+    covered += interval.end - interval.start;
+  }
+  EXPECT_EQ(covered + result.spilled.size(), 7 * 8);
+  ASSERT_EQ(result.assignment.size(), result.intervals.size());
+  for (const auto &a : result.intervals) {
+    EXPECT_LE(result.assignment.at(a.var), 1);
+    for (const auto &b : result.intervals) {
+      if (a.var != b.var && a.start < b.end && b.start < a.end) {
+        EXPECT_NE(result.assignment.at(a.var), result.assignment.at(b.var));
+      }
+    }
+  }
+}
+
+TEST(AllocatorContext, SweepRegisterCountsWithOneLoad) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+  const InterferenceGraph<Variable> &ig = CSVReader::load(GRAPH);
+
+  const auto &allocation = assignRegisters(ig, 6);
+  IGWriter::write(ig, "gtest/graphs/complete_6_loaded.dot", allocation);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, allocation));
+  EXPECT_TRUE(assignRegisters(ig, 5).empty());
+
+  AllocatorContext context(ig);
+  for (int k = 1; k <= 8; k++) {
+    const auto &swept = context.assignRegisters(k);
+    if (k < 6) {
+      EXPECT_TRUE(swept.empty());
+    } else {
+      EXPECT_TRUE(verifyAllocation(GRAPH, k, swept));
+    }
+  }
+}
+
+TEST(AllocatorContext, CachesEveryEngine) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  AllocatorContext context(GRAPH);
+
+  // Exact finds the two-coloring, below the d(G) + 1 that greedy needs.
+  for (int k = 2; k <= 4; k++) {
+    EXPECT_TRUE(verifyAllocation(
+        GRAPH, k, context.assignRegisters(k, Engine::Exact)));
+  }
+  EXPECT_TRUE(context.assignRegisters(1, Engine::Exact).empty());
+
+  const int enough = context.graph().size();
+  EXPECT_TRUE(verifyAllocation(
+      GRAPH, enough, context.assignRegisters(enough, Engine::LocalSearch)));
+  EXPECT_TRUE(verifyAllocation(GRAPH, enough, context.assignRegisters(enough)));
+}
+
+TEST(CompressedInput, GzipGraphMatchesPlain) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  const auto &GZIPPED = "gtest/graphs/big_bipartite.csv.gz";
+  std::ifstream plain(GRAPH, std::ios::binary);
+  const std::string text((std::istreambuf_iterator<char>(plain)),
+                         std::istreambuf_iterator<char>());
+
+  // Two gzip members back to back, split mid-line.
+  {
+    std::ofstream out(GZIPPED, std::ios::binary | std::ios::trunc);
+    for (const auto &part :
+         {text.substr(0, text.size() / 2), text.substr(text.size() / 2)}) {
+      uLongf size = compressBound(part.size()) + 32;
+      std::vector<Bytef> member(size);
+      z_stream stream{};
+      deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY);
+      stream.next_in =
+          reinterpret_cast<Bytef *>(const_cast<char *>(part.data()));
+      stream.avail_in = static_cast<uInt>(part.size());
+      stream.next_out = member.data();
+      stream.avail_out = static_cast<uInt>(size);
+      ASSERT_EQ(deflate(&stream, Z_FINISH), Z_STREAM_END);
+      out.write(reinterpret_cast<const char *>(member.data()),
+                static_cast<std::streamsize>(stream.total_out));
+      deflateEnd(&stream);
+    }
+  }
+
+  EXPECT_EQ(InputFile(GZIPPED).format(), InputFile::Format::Gzip);
+  const InterferenceGraph<Variable> &expected = CSVReader::load(GRAPH);
+  const InterferenceGraph<Variable> &ig = CSVReader::loadPipelined(GZIPPED);
+  EXPECT_EQ(ig.numVertices(), expected.numVertices());
+  EXPECT_EQ(ig.numEdges(), expected.numEdges());
+  for (const auto &v : expected.vertices()) {
+    EXPECT_EQ(ig.neighbors(v), expected.neighbors(v));
+  }
+  EXPECT_EQ(CSVReader::loadCompact(GZIPPED).numEdges(), expected.numEdges());
+  EXPECT_EQ(AssignmentCache::keyFor(GZIPPED, 3, Engine::WelshPowell).hex(),
+            AssignmentCache::keyFor(GRAPH, 3, Engine::WelshPowell).hex());
+}
+
+TEST(CompressedInput, BadCompressedFilesThrow) {
+  const auto &TRUNCATED = "gtest/graphs/truncated.csv.gz";
+  {
+    std::ofstream out(TRUNCATED, std::ios::binary | std::ios::trunc);
+    const char header[] = {'\x1f', '\x8b', '\x08', '\x00', '\x00'};
+    out.write(header, sizeof(header));
+  }
+  EXPECT_THROW(CSVReader::loadPipelined(TRUNCATED), std::runtime_error);
+
+#ifndef PROJ6_WITH_ZSTD
+  const auto &ZSTD = "gtest/graphs/unsupported.csv.zst";
+  {
+    std::ofstream out(ZSTD, std::ios::binary | std::ios::trunc);
+    out.write("\x28\xb5\x2f\xfd", 4);
+  }
+  EXPECT_THROW(CSVReader::loadIntervals(ZSTD), std::runtime_error);
+#endif
+}
+
+TEST(FlatHashMap, MatchesUnorderedMapUnderChurn) {
+  FlatHashMap<std::string, int> flat;
+  std::unordered_map<std::string, int> expected;
+  for (int i = 0; i < 20000; i++) {
+    const auto &key = std::to_string((i * 7919) % 1500);
+    if (i % 3 == 2) {
+      EXPECT_EQ(flat.erase(key), expected.erase(key));
+    } else {
+      flat[key] = i;
+      expected[key] = i;
+    }
+  }
+  ASSERT_EQ(flat.size(), expected.size());
+  for (const auto &[key, value] : flat) {
+    EXPECT_EQ(expected.at(key), value);
+  }
+  for (const auto &[key, value] : expected) {
+    EXPECT_EQ(flat.at(key), value);
+  }
+  EXPECT_EQ(flat.find("missing"), flat.end());
+  EXPECT_THROW(flat.at("missing"), std::out_of_range);
+
+  flat.clear();
+  EXPECT_TRUE(flat.empty());
+  FlatHashSet<Register> set;
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_FALSE(set.insert(3));
+  EXPECT_TRUE(set.contains(3));
+  EXPECT_EQ(set.erase(3), 1);
+  EXPECT_FALSE(set.contains(3));
+}
+
+TEST(FlatHashMap, IntegerKeysSpreadOverTheTable) {
+  // std::hash of an integer is the identity, so these keys are the worst
+  // case for a table that splits the raw hash: dense small integers share
+  // a few home groups and fingerprints, and large strides share one.
+  const int N = 50000;
+  for (const std::uint64_t stride : {1ULL, 128ULL, 1ULL << 20}) {
+    FlatHashMap<std::uint64_t, int> table;
+    for (int i = 0; i < N; i++) {
+      table[i * stride] = i;
+    }
+
+    // Present and absent keys alike should take about one group and at
+    // most a couple of key comparisons on average.
+    std::size_t groups = 0;
+    std::size_t compares = 0;
+    for (int i = 0; i < 2 * N; i++) {
+      const auto &count = table.probeCount(i * stride);
+      groups += count.groups;
+      compares += count.compares;
+    }
+    EXPECT_LT(groups, 2 * 2 * N) << "stride " << stride;
+    EXPECT_LT(compares, 2 * 2 * N) << "stride " << stride;
+  }
+
+  // The register sets of a greedy coloring: small registers.
+  FlatHashSet<Register> registers;
+  for (Register r = 1; r <= 3000; r++) {
+    registers.insert(r);
+  }
+  std::size_t groups = 0;
+  for (Register r = 1; r <= 3000; r++) {
+    groups += registers.probeCount(r).groups;
+  }
+  EXPECT_LT(groups, 2 * 3000);
+}
+
+TEST(AllocationServer, ServesPathsTextAndBinaryGraphs) {
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+  const auto &SOCKET = "gtest/graphs/allocation_test.sock";
+  AllocationServer server(SOCKET, {2, 4});
+  server.start();
+
+  AllocationClient client(SOCKET);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, client.assignRegisters(GRAPH, 6)));
+  // Same graph, other register counts: served from the cached graph.
+  EXPECT_TRUE(client.assignRegisters(GRAPH, 5).empty());
+  EXPECT_TRUE(verifyAllocation(
+      GRAPH, 7, client.assignRegisters(GRAPH, 7, Engine::Exact)));
+  EXPECT_EQ(server.requests(), 3);
+  EXPECT_EQ(server.cacheHits(), 2);
+
+  const InterferenceGraph<Variable> &ig = CSVReader::load(GRAPH);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 6, client.assignRegisters(ig, 6)));
+
+  std::ifstream in(GRAPH);
+  const std::string csv((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+  EXPECT_TRUE(
+      verifyAllocation(GRAPH, 6, client.assignRegistersFromCsv(csv, 6)));
+
+  server.stop();
+}
+
+TEST(AllocationServer, RelativePathsFollowTheClient) {
+  // The server runs in another process started in another directory, as
+  // a daemon would; the client's relative path must still name its file.
+  const auto &GRAPH = "gtest/graphs/complete_6.csv";
+  const std::string socketPath =
+      std::filesystem::absolute("gtest/graphs/allocation_cwd.sock").string();
+  int ready[2];
+  ASSERT_EQ(pipe(ready), 0);
+  const pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    close(ready[0]);
+    if (chdir("/") == 0) {
+      try {
+        AllocationServer server(socketPath, {1});
+        server.start();
+        if (write(ready[1], "1", 1) == 1) {
+          for (;;) {
+            pause();
+          }
+        }
+      } catch (...) {
+      }
+    }
+    _exit(1);
+  }
+  close(ready[1]);
+  char byte = 0;
+  const bool started = read(ready[0], &byte, 1) == 1;
+  close(ready[0]);
+
+  if (started) {
+    AllocationClient client(socketPath);
+    try {
+      EXPECT_TRUE(
+          verifyAllocation(GRAPH, 6, client.assignRegisters(GRAPH, 6)));
+    } catch (const std::exception &e) {
+      ADD_FAILURE() << e.what();
+    }
+  }
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+  std::filesystem::remove(socketPath);
+  EXPECT_TRUE(started);
+}
+
+TEST(AllocationServer, ReportsErrorsAndKeepsServing) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+  const auto &SOCKET = "gtest/graphs/allocation_errors.sock";
+  AllocationServer server(SOCKET);
+  server.start();
+
+  // Several clients at once, each on its own connection.
+  std::vector<std::thread> clients;
+  std::atomic<int> verified{0};
+  for (int c = 0; c < 4; c++) {
+    clients.emplace_back([&]() {
+      AllocationClient client(SOCKET);
+      EXPECT_THROW(client.assignRegisters("gtest/graphs/missing.csv", 3),
+                   std::runtime_error);
+      EXPECT_THROW(client.assignRegistersFromCsv("a,b,c\n", 3),
+                   std::runtime_error);
+      for (int i = 0; i < 10; i++) {
+        if (verifyAllocation(GRAPH, 8, client.assignRegisters(GRAPH, 8))) {
+          verified++;
+        }
+      }
+    });
+  }
+  for (auto &client : clients) {
+    client.join();
+  }
+  EXPECT_EQ(verified.load(), 40);
+  EXPECT_EQ(server.requests(), 48);
+  server.stop();
+
+  AllocationClient client(SOCKET);
+  EXPECT_THROW(client.assignRegisters(GRAPH, 8), std::runtime_error);
+}
+
+TEST(GraphClass, ClassifiesAndColorsOptimally) {
+  const auto check = [](const InterferenceGraph<Variable> &ig,
+                        GraphClass expected, Register maxRegisters) {
+    const IndexedGraph graph(ig);
+    EXPECT_EQ(classifyGraph(graph), expected);
+    const ClassColoring &result = colorByClass(graph);
+    EXPECT_EQ(result.graphClass, expected);
+    // Exact for the optimal classes, since the coloring is checked below.
+    EXPECT_LE(result.numRegisters, maxRegisters);
+    for (IndexedGraph::Id v = 0; v < graph.size(); v++) {
+      EXPECT_GE(result.colors[v], 1);
+      graph.forEachNeighbor(v, [&](IndexedGraph::Id w) {
+        if (w != v) {
+          EXPECT_NE(result.colors[v], result.colors[w]);
+        }
+      });
+    }
+  };
+
+  InterferenceGraph<Variable> edgeless;
+  edgeless.addVertex("a");
+  edgeless.addVertex("b");
+  edgeless.addEdge("c", "c");
+  check(edgeless, GraphClass::Edgeless, 1);
+
+  check(CSVReader::load("gtest/graphs/complete_6.csv"), GraphClass::Complete,
+        6);
+  check(CSVReader::load("gtest/graphs/big_bipartite.csv"),
+        GraphClass::Bipartite, 2);
+
+  InterferenceGraph<Variable> tree;
+  for (int i = 1; i < 50; i++) {
+    tree.addEdge(std::to_string(i), std::to_string((i - 1) / 3));
+  }
+  tree.addVertex("alone");
+  check(tree, GraphClass::Forest, 2);
+
+  // A wheel: odd cycles through the hub, and the hub's degree is too
+  // large for the mask-based colorer.
+  InterferenceGraph<Variable> wheel;
+  for (int i = 0; i < 80; i++) {
+    wheel.addEdge("hub", std::to_string(i));
+    wheel.addEdge(std::to_string(i), std::to_string((i + 1) % 80));
+  }
+  check(wheel, GraphClass::General, 4);
+  wheel.removeVertex("hub");
+  wheel.addEdge("0", "2");
+  check(wheel, GraphClass::SmallDegree, 4);
+}
+
+TEST(GraphClass, AutoEngineBeatsWelshPowellBound) {
+  const auto &GRAPH = "gtest/graphs/big_bipartite.csv";
+  EXPECT_TRUE(assignRegisters(GRAPH, 2).empty());
+  EXPECT_TRUE(verifyAllocation(GRAPH, 2, assignRegisters(GRAPH, 2,
+                                                          Engine::Auto)));
+  EXPECT_TRUE(assignRegisters(GRAPH, 1, Engine::Auto).empty());
+
+  const auto &COMPLETE = "gtest/graphs/complete_6.csv";
+  AllocatorContext context(COMPLETE);
+  EXPECT_TRUE(context.assignRegisters(5, Engine::Auto).empty());
+  EXPECT_TRUE(
+      verifyAllocation(COMPLETE, 6, context.assignRegisters(6, Engine::Auto)));
+}
+
+TEST(Coalescing, MovesShareRegisters) {
+  const auto &GRAPH = "gtest/graphs/coalesce_chain.csv";
+  const auto &MOVES = "gtest/graphs/coalesce_chain_moves.csv";
+  std::ofstream("gtest/graphs/coalesce_chain.csv") << "a,b\nb,c\nc,d\n";
+  // The a,b move cannot be coalesced since a and b interfere.
+  std::ofstream("gtest/graphs/coalesce_chain_moves.csv")
+      << "a,c\nb,d\na,b\nmissing,a\n";
+
+  const MoveList &moves = loadMoves(MOVES);
+  ASSERT_EQ(moves.size(), 4);
+
+  const auto &allocation = assignRegisters(GRAPH, 2, moves);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 2, allocation));
+  EXPECT_EQ(allocation.at("a"), allocation.at("c"));
+  EXPECT_EQ(allocation.at("b"), allocation.at("d"));
+  EXPECT_TRUE(assignRegisters(GRAPH, 1, moves).empty());
+}
+
+TEST(Coalescing, RefusesMergesThatCouldNeedMoreRegisters) {
+  // Merging a and c closes the triangle a-x-y, which needs 3 registers.
+  InterferenceGraph<Variable> ig;
+  ig.addEdge("a", "x");
+  ig.addEdge("x", "y");
+  ig.addEdge("y", "c");
+  const IndexedGraph graph(ig);
+  const std::vector<std::pair<IndexedGraph::Id, IndexedGraph::Id>> moves = {
+      {graph.id("a"), graph.id("c")}};
+
+  const CoalesceResult &tight = coalesceMoves(graph, moves, 2);
+  EXPECT_EQ(tight.coalescedMoves, 0);
+  const auto &two = assignRegisters(ig, 2, MoveList{{"a", "c"}});
+  ASSERT_EQ(two.size(), 4);
+  EXPECT_NE(two.at("a"), two.at("c"));
+
+  const CoalesceResult &loose = coalesceMoves(graph, moves, 3);
+  EXPECT_EQ(loose.coalescedMoves, 1);
+  EXPECT_EQ(loose.representative[graph.id("a")],
+            loose.representative[graph.id("c")]);
+  const auto &three = assignRegisters(ig, 3, MoveList{{"a", "c"}});
+  EXPECT_EQ(three.at("a"), three.at("c"));
+  EXPECT_NE(three.at("x"), three.at("y"));
+}
+
+TEST(Coalescing, StaysWithinMaxDegreePlusOne) {
+  // A matching needs 2 registers, but merging b1~a2, b2~a3 and b3~a1
+  // turns it into a triangle. Three registers would allow that, but the
+  // result must still use at most d(G) + 1 = 2.
+  InterferenceGraph<Variable> ig;
+  ig.addEdge("a1", "b1");
+  ig.addEdge("a2", "b2");
+  ig.addEdge("a3", "b3");
+  const MoveList moves = {{"b1", "a2"}, {"b2", "a3"}, {"b3", "a1"}};
+
+  const auto &allocation = assignRegisters(ig, 3, moves);
+  ASSERT_EQ(allocation.size(), 6);
+  for (const auto &v : ig.vertices()) {
+    EXPECT_LE(allocation.at(v), 2);
+    for (const auto &w : ig.neighbors(v)) {
+      EXPECT_NE(allocation.at(v), allocation.at(w));
+    }
+  }
+}
+
+TEST(AllocationServer, IdleAndStalledClientsDoNotHoldWorkers) {
+  const auto &GRAPH = "gtest/graphs/simple.csv";
+  const auto &SOCKET = "gtest/graphs/allocation_idle.sock";
+  AllocationServer server(SOCKET, {1, 4, std::chrono::milliseconds(200)});
+  server.start();
+
+  // A keeps its connection open after its request, and the raw socket
+  // sends half a frame header and then nothing.
+  AllocationClient idle(SOCKET);
+  EXPECT_TRUE(verifyAllocation(GRAPH, 3, idle.assignRegisters(GRAPH, 3)));
+  const int stalled = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strcpy(address.sun_path, SOCKET);
+  ASSERT_EQ(connect(stalled, reinterpret_cast<sockaddr *>(&address),
+                    sizeof(address)),
+            0);
+  ASSERT_EQ(write(stalled, "RAQ1", 4), 4);
+
+  // With a single worker, B is served anyway.
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 5; i++) {
+    AllocationClient other(SOCKET);
+    EXPECT_TRUE(verifyAllocation(GRAPH, 3, other.assignRegisters(GRAPH, 3)));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  EXPECT_TRUE(verifyAllocation(GRAPH, 3, idle.assignRegisters(GRAPH, 3)));
+
+  // The stalled peer was dropped once its timeout ran out.
+  char byte;
+  EXPECT_EQ(read(stalled, &byte, 1), 0);
+  close(stalled);
+  server.stop();
+}
+
 }  // end namespace
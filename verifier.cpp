@@ -19,30 +19,13 @@
 
 using namespace proj6;
 
-testing::AssertionResult verifyAllocation(const std::string &path_to_graph,
-                                          int num_registers,
-                                          const RegisterAssignment &mapping) {
-  std::string line;
-  std::ifstream file_stream(path_to_graph);
-  std::unordered_map<Variable, unsigned> degrees;
-  std::unordered_set<Variable> variables;
-  std::vector<std::pair<Variable, Variable>> interferences;
-
-  while (std::getline(file_stream, line)) {
-    const auto &row = CSVReader::readRow(line);
-    for (const auto &v : row) {
-      variables.insert(v);
-      if (degrees.find(v) == degrees.end()) {
-        degrees[v] = 0;
-      }
-    }
-    if (row.size() == 2) {
-      degrees[row[0]]++;
-      degrees[row[1]]++;
-      interferences.push_back(std::make_pair(row[0], row[1]));
-    }
-  }
+namespace {
 
+testing::AssertionResult checkAllocation(
+    const std::unordered_set<Variable> &variables,
+    const std::unordered_map<Variable, unsigned> &degrees,
+    const std::vector<std::pair<Variable, Variable>> &interferences,
+    int num_registers, const RegisterAssignment &mapping) {
   for (const auto &v : variables) {
     if (mapping.find(v) == mapping.end()) {
       return testing::AssertionFailure()
@@ -85,4 +68,55 @@ testing::AssertionResult verifyAllocation(const std::string &path_to_graph,
   }
 
   return testing::AssertionSuccess();
-}
\ No newline at end of file
+}
+
+};  // namespace
+
+testing::AssertionResult verifyAllocation(const std::string &path_to_graph,
+                                          int num_registers,
+                                          const RegisterAssignment &mapping) {
+  std::string line;
+  std::ifstream file_stream(path_to_graph);
+  std::unordered_map<Variable, unsigned> degrees;
+  std::unordered_set<Variable> variables;
+  std::vector<std::pair<Variable, Variable>> interferences;
+
+  while (std::getline(file_stream, line)) {
+    const auto &row = CSVReader::readRow(line);
+    for (const auto &v : row) {
+      variables.insert(v);
+      if (degrees.find(v) == degrees.end()) {
+        degrees[v] = 0;
+      }
+    }
+    if (row.size() == 2) {
+      degrees[row[0]]++;
+      degrees[row[1]]++;
+      interferences.push_back(std::make_pair(row[0], row[1]));
+    }
+  }
+
+  return checkAllocation(variables, degrees, interferences, num_registers,
+                         mapping);
+}
+
+testing::AssertionResult verifyAllocation(
+    const GraphSnapshot<Variable> &snapshot, int num_registers,
+    const RegisterAssignment &mapping) {
+  std::unordered_map<Variable, unsigned> degrees;
+  std::unordered_set<Variable> variables = snapshot.vertices();
+  std::vector<std::pair<Variable, Variable>> interferences;
+
+  for (const auto &v : variables) {
+    const auto &neighbors = snapshot.neighbors(v);
+    degrees[v] = static_cast<unsigned>(neighbors.size());
+    for (const auto &w : neighbors) {
+      if (v < w) {
+        interferences.push_back(std::make_pair(v, w));
+      }
+    }
+  }
+
+  return checkAllocation(variables, degrees, interferences, num_registers,
+                         mapping);
+}
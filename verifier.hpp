@@ -1,6 +1,7 @@
 #ifndef __VERIFIER__HPP
 #define __VERIFIER__HPP
 
+#include "VersionedInterferenceGraph.hpp"
 #include "gtest/gtest.h"
 #include "proj6.hpp"
 
@@ -10,4 +11,10 @@ testing::AssertionResult verifyAllocation(const std::string &path_to_graph,
                                           int num_registers,
                                           const RegisterAssignment &mapping);
 
+// Same checks against a snapshot of a VersionedInterferenceGraph instead of
+// a graph file.
+testing::AssertionResult verifyAllocation(
+    const GraphSnapshot<Variable> &snapshot, int num_registers,
+    const RegisterAssignment &mapping);
+
 #endif
\ No newline at end of file